@@ -92,6 +92,7 @@ int freeMemory();
 #define HAL_ADC_RESOLUTION     10
 #define HAL_READ_ADC()         HAL_adc_get_result()
 #define HAL_ADC_READY()        true
+#define HAL_ADC_SCAN                  // Simulated inputs can be read at any time
 
 void HAL_adc_init();
 void HAL_adc_enable_channel(int pin);
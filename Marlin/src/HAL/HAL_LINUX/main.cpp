@@ -36,6 +36,15 @@ extern void loop();
 #include "hardware/Heater.h"
 #include "hardware/LinearAxis.h"
 
+#if ENABLED(MOTION_BENCHMARK)
+  #include "../../feature/benchmark.h"
+  #include <unistd.h>
+  static FILE *gcode_source = stdin;
+  #if ENABLED(BINARY_GCODE_STREAMING)
+    #include "../../feature/binary_protocol.h"
+  #endif
+#endif
+
 // simple stdout / stdin implementation for fake serial port
 void write_serial_thread() {
   for (;;) {
@@ -46,16 +55,63 @@ void write_serial_thread() {
   }
 }
 
-void read_serial_thread() {
-  char buffer[255] = {};
-  for (;;) {
-    std::size_t len = _MIN(usb_serial.receive_buffer.free(), 254U);
-    if (fgets(buffer, len, stdin))
-      for (std::size_t i = 0; i < strlen(buffer); i++)
+#if ENABLED(MOTION_BENCHMARK)
+
+  // Feed the G-code source as raw bytes, so binary streams get through too
+  void read_serial_thread() {
+    char buffer[255] = {};
+    for (;;) {
+      std::size_t len = _MIN(usb_serial.receive_buffer.free(), 254U);
+      #if BENCHMARK_SERIAL_BAUD
+        // No more than a serial line (8N1) could have carried by now
+        const uint64_t line_bytes = Clock::micros() * ((BENCHMARK_SERIAL_BAUD) / 10) / 1000000UL;
+        len = _MIN(len, std::size_t(line_bytes - benchmark.serial_bytes));
+      #endif
+      const ssize_t r = len ? read(fileno(gcode_source), buffer, len) : 0, n = _MAX(r, 0);
+      #if ENABLED(BINARY_GCODE_STREAMING)
+        // Output of binary_gcode.py starts with a packet, as if M28 B1 was sent before
+        if (!benchmark.serial_bytes && n && uint8_t(buffer[0]) == (BinaryStream::Packet::Header::HEADER_TOKEN & 0xFF))
+          BinaryStream::active = true;
+      #endif
+      for (ssize_t i = 0; i < n; i++)
         usb_serial.receive_buffer.write(buffer[i]);
-    std::this_thread::yield();
+      benchmark.serial_bytes += n;
+      if (len && !r) {
+        // Wait for Marlin to pick up the tail of the file, then flag the end of input
+        while (usb_serial.receive_buffer.available()) std::this_thread::yield();
+        benchmark.input_done = true;
+        return;
+      }
+      std::this_thread::yield();
+    }
   }
-}
+
+#else
+
+  void read_serial_thread() {
+    char buffer[255] = {};
+    for (;;) {
+      std::size_t len = _MIN(usb_serial.receive_buffer.free(), 254U);
+      if (fgets(buffer, len, stdin))
+        for (std::size_t i = 0; i < strlen(buffer); i++)
+          usb_serial.receive_buffer.write(buffer[i]);
+      std::this_thread::yield();
+    }
+  }
+
+#endif
+
+#if ENABLED(MOTION_BENCHMARK)
+  // Print the report and quit once the input is exhausted and all motion is done
+  void benchmark_thread() {
+    while (!benchmark.finished()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    benchmark.report();
+    while (usb_serial.transmit_buffer.available()) std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    fflush(stdout);
+    _exit(0);
+  }
+#endif
 
 void simulation_loop() {
   Heater hotend(HEATER_0_PIN, TEMP_0_PIN);
@@ -104,7 +160,20 @@ void simulation_loop() {
   }
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+  double time_multiplier = 1.0; // some testing at 10x
+
+  #if ENABLED(MOTION_BENCHMARK)
+    // Usage: marlin [gcode_file [time_multiplier]]
+    if (argc > 1 && !(gcode_source = fopen(argv[1], "rb"))) {
+      fprintf(stderr, "Can't open %s\n", argv[1]);
+      return 1;
+    }
+    if (argc > 2) time_multiplier = atof(argv[2]);
+  #else
+    UNUSED(argc); UNUSED(argv);
+  #endif
+
   std::thread write_serial (write_serial_thread);
   std::thread read_serial (read_serial_thread);
 
@@ -115,7 +184,7 @@ int main() {
   #endif
 
   Clock::setFrequency(F_CPU);
-  Clock::setTimeMultiplier(1.0); // some testing at 10x
+  Clock::setTimeMultiplier(time_multiplier);
 
   HAL_timer_init();
 
@@ -123,6 +192,10 @@ int main() {
 
   DELAY_US(10000);
 
+  #if ENABLED(MOTION_BENCHMARK)
+    std::thread benchmark_watch (benchmark_thread);
+  #endif
+
   setup();
   for (;;) {
     loop();
@@ -25,6 +25,80 @@
 #include "../../inc/MarlinConfigPre.h"
 #include "MarlinSerial.h"
 
+#if ENABLED(SERIAL_DMA)
+
+  #define SBIT_PCGPDMA    29  // PCONP: GPDMA power
+  #define SBIT_DMACEN      0  // DMACConfig: controller enable
+  #define SBIT_RBRIE       0  // UnIER: receive data interrupt
+  #define SBIT_RLSIE       2  // UnIER: line status interrupt
+  #define SBIT_FIFOEN      0  // UnFCR: FIFO enable
+  #define SBIT_DMAMODE     3  // UnFCR: DMA request on received data (trigger level 1 character)
+  #define SBIT_DI         27  // DMACCControl: increment destination
+  #define SBIT_CHEN        0  // DMACCConfig: channel enable
+  #define SBIT_SRCPERIPH   1  // DMACCConfig: source request line
+  #define SBIT_FLOWCNTRL  11  // DMACCConfig: transfer type
+  #define DMA_P2M          2  // Peripheral to memory, DMA controlled
+
+  void MarlinSerial::begin(const uint32_t baud) {
+    HardwareSerial<UART_RX_BUFFER_SIZE, TX_BUFFER_SIZE>::begin(baud);
+
+    // UART n raises its receive request on DMA line 9 + 2n (DMAREQSEL reset value selects the UARTs)
+    // and gets channel n, so all four ports can be in use
+    const uint8_t n = uart == LPC_UART0 ? 0 : uart == (LPC_UART_TypeDef *)LPC_UART1 ? 1 : uart == LPC_UART2 ? 2 : 3;
+    channel = (LPC_GPDMACH_TypeDef *)(LPC_GPDMACH0_BASE + n * (LPC_GPDMACH1_BASE - LPC_GPDMACH0_BASE));
+
+    SBI(LPC_SC->PCONP, SBIT_PCGPDMA);
+    SBI(LPC_GPDMA->DMACConfig, SBIT_DMACEN);
+
+    channel->DMACCConfig = 0;
+    LPC_GPDMA->DMACIntTCClear = LPC_GPDMA->DMACIntErrClr = _BV(n);
+
+    // Single bytes from RBR into the buffer. At the end of the buffer the channel
+    // loads the same item again and starts over, without an interrupt.
+    rx_lli.src = (uint32_t)&uart->RBR;
+    rx_lli.dest = uint32_t(rx_buffer);
+    rx_lli.next = uint32_t(&rx_lli);
+    rx_lli.control = RX_BUFFER_SIZE | _BV(SBIT_DI);
+
+    channel->DMACCSrcAddr = rx_lli.src;
+    channel->DMACCDestAddr = rx_lli.dest;
+    channel->DMACCLLI = rx_lli.next;
+    channel->DMACCControl = rx_lli.control;
+
+    rx_tail = 0;
+    #if ENABLED(EMERGENCY_PARSER)
+      rx_scanned = 0;
+    #endif
+
+    // Hand the receiver to the DMA channel. THRE stays enabled for transmit.
+    uart->IER &= ~(_BV(SBIT_RBRIE) | _BV(SBIT_RLSIE));
+    uart->FCR = _BV(SBIT_FIFOEN) | _BV(SBIT_DMAMODE);
+    channel->DMACCConfig = _BV(SBIT_CHEN) | ((9 + 2 * n) << SBIT_SRCPERIPH) | (DMA_P2M << SBIT_FLOWCNTRL);
+  }
+
+  int MarlinSerial::available() {
+    #if ENABLED(EMERGENCY_PARSER)
+      poll();
+    #endif
+    return (rx_head() - rx_tail) & (RX_BUFFER_SIZE - 1);
+  }
+
+  int MarlinSerial::peek() {
+    return rx_head() == rx_tail ? -1 : rx_buffer[rx_tail];
+  }
+
+  int MarlinSerial::read() {
+    #if ENABLED(EMERGENCY_PARSER)
+      poll();
+    #endif
+    if (rx_head() == rx_tail) return -1;
+    const uint8_t c = rx_buffer[rx_tail];
+    rx_tail = (rx_tail + 1) & (RX_BUFFER_SIZE - 1);
+    return c;
+  }
+
+#endif // SERIAL_DMA
+
 #if (defined(SERIAL_PORT) && SERIAL_PORT == 0) || (defined(SERIAL_PORT_2) && SERIAL_PORT_2 == 0)
   MarlinSerial MSerial(LPC_UART0);
   extern "C" void UART0_IRQHandler() {
@@ -39,10 +39,20 @@
   #define TX_BUFFER_SIZE 32
 #endif
 
-class MarlinSerial : public HardwareSerial<RX_BUFFER_SIZE, TX_BUFFER_SIZE> {
+#if ENABLED(SERIAL_DMA)
+  // Received bytes go to the DMA buffer. The framework's buffer stays unused.
+  #define UART_RX_BUFFER_SIZE 16
+#else
+  #define UART_RX_BUFFER_SIZE RX_BUFFER_SIZE
+#endif
+
+class MarlinSerial : public HardwareSerial<UART_RX_BUFFER_SIZE, TX_BUFFER_SIZE> {
 public:
   MarlinSerial(LPC_UART_TypeDef *UARTx) :
-    HardwareSerial<RX_BUFFER_SIZE, TX_BUFFER_SIZE>(UARTx)
+    HardwareSerial<UART_RX_BUFFER_SIZE, TX_BUFFER_SIZE>(UARTx)
+    #if ENABLED(SERIAL_DMA)
+      , uart(UARTx), rx_tail(0)
+    #endif
     #if ENABLED(EMERGENCY_PARSER)
        , emergency_state(EmergencyParser::State::EP_RESET)
     #endif
@@ -51,14 +61,48 @@ public:
 
   void end() {}
 
+  #if ENABLED(SERIAL_DMA)
+    void begin(const uint32_t baud);
+    int available();
+    int peek();
+    int read();
+    void flush() { HardwareSerial<UART_RX_BUFFER_SIZE, TX_BUFFER_SIZE>::flush(); rx_tail = rx_head(); }
+  #endif
+
   #if ENABLED(EMERGENCY_PARSER)
     bool recv_callback(const char c) override {
       emergency_parser.update(emergency_state, c);
       return true; // do not discard character
     }
 
+    #if ENABLED(SERIAL_DMA)
+      // No interrupt sees the bytes arrive, so the parser has to be polled
+      void poll() {
+        for (const uint16_t head = rx_head(); rx_scanned != head; rx_scanned = (rx_scanned + 1) & (RX_BUFFER_SIZE - 1))
+          recv_callback(rx_buffer[rx_scanned]);
+      }
+    #endif
+
     EmergencyParser::State emergency_state;
   #endif
+
+  #if ENABLED(SERIAL_DMA)
+    private:
+      // A GPDMA linked list item. Pointing it at itself makes the transfer circular.
+      struct dma_lli_t { uint32_t src, dest, next, control; };
+
+      LPC_UART_TypeDef * const uart;
+      LPC_GPDMACH_TypeDef *channel;
+      dma_lli_t rx_lli;
+      uint8_t rx_buffer[RX_BUFFER_SIZE];
+      uint16_t rx_tail;
+      #if ENABLED(EMERGENCY_PARSER)
+        uint16_t rx_scanned;
+      #endif
+
+      // The write position of the DMA channel
+      inline uint16_t rx_head() { return (channel->DMACCDestAddr - uint32_t(rx_buffer)) & (RX_BUFFER_SIZE - 1); }
+  #endif
 };
 
 extern MarlinSerial MSerial;
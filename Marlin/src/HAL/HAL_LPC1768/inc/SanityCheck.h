@@ -36,6 +36,14 @@
 //  #error "SPINDLE_LASER_PWM_PIN must use SERVO0, SERVO1 or SERVO3 connector"
 //#endif
 
+#if ENABLED(SERIAL_DMA)
+  #if SERIAL_PORT == -1 && !(defined(SERIAL_PORT_2) && SERIAL_PORT_2 >= 0)
+    #error "SERIAL_DMA requires a hardware SERIAL_PORT or SERIAL_PORT_2."
+  #elif defined(RX_BUFFER_SIZE) && (RX_BUFFER_SIZE < 16 || RX_BUFFER_SIZE > 2048 || (RX_BUFFER_SIZE & (RX_BUFFER_SIZE - 1)))
+    #error "SERIAL_DMA requires RX_BUFFER_SIZE to be a power of 2 from 16 to 2048."
+  #endif
+#endif
+
 #if IS_RE_ARM_BOARD && ENABLED(REPRAP_DISCOUNT_FULL_GRAPHIC_SMART_CONTROLLER) && HAS_DRIVER(TMC2130) && DISABLED(TMC_USE_SW_SPI)
   #error "Re-ARM with REPRAP_DISCOUNT_FULL_GRAPHIC_SMART_CONTROLLER and TMC2130 require TMC_USE_SW_SPI"
 #endif
@@ -165,6 +165,15 @@ void HAL_idletask() {
   #endif
   // Perform USB stack housekeeping
   MSC_RunDeferredCommands();
+  #if BOTH(SERIAL_DMA, EMERGENCY_PARSER)
+    // Catch M108 / M112 / M410 while the command queue isn't read
+    #if SERIAL_PORT >= 0
+      MYSERIAL0.poll();
+    #endif
+    #if defined(SERIAL_PORT_2) && SERIAL_PORT_2 >= 0
+      MYSERIAL1.poll();
+    #endif
+  #endif
 }
 
 #endif // TARGET_LPC1768
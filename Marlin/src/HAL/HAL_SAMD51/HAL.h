@@ -110,6 +110,7 @@ extern uint16_t HAL_adc_result;     // result of last ADC conversion
 void HAL_adc_init();
 
 #define HAL_ADC_FILTERED            // Disable oversampling done in Marlin as ADC values already filtered in HAL
+#define HAL_ADC_SCAN                // DMA keeps every ADC input up to date, so any can be read at once
 #define HAL_ADC_RESOLUTION  12
 #define HAL_START_ADC(pin)  HAL_adc_start_conversion(pin)
 #define HAL_READ_ADC()      HAL_adc_result
@@ -110,6 +110,10 @@
   #include "feature/I2CPositionEncoder.h"
 #endif
 
+#if ENABLED(BENCHMARK_COMMAND_PROFILE)
+  #include "feature/benchmark.h"
+#endif
+
 #if HAS_TRINAMIC && DISABLED(PS_DEFAULT_OFF)
   #include "feature/tmc_util.h"
 #endif
@@ -437,7 +441,13 @@ void manage_inactivity(const bool ignore_stepper_queue/*=false*/) {
 
   if (max_inactive_time && ELAPSED(ms, gcode.previous_move_ms + max_inactive_time)) {
     SERIAL_ERROR_START();
-    SERIAL_ECHOLNPAIR(MSG_KILL_INACTIVE_TIME, parser.command_ptr);
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      SERIAL_ECHOPGM(MSG_KILL_INACTIVE_TIME);
+      parser.echo_command();
+      SERIAL_EOL();
+    #else
+      SERIAL_ECHOLNPAIR(MSG_KILL_INACTIVE_TIME, parser.command_ptr);
+    #endif
     kill();
   }
 
@@ -630,6 +640,10 @@ void idle(
     bool no_stepper_sleep/*=false*/
   #endif
 ) {
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.idle_start();
+  #endif
+
   #if ENABLED(POWER_LOSS_RECOVERY) && PIN_EXISTS(POWER_LOSS)
     recovery.outage();
   #endif
@@ -649,6 +663,22 @@ void idle(
     max7219.idle_tasks();
   #endif
 
+  #if ENABLED(SEGMENT_COALESCING)
+    planner.coalesce_idle();
+  #endif
+
+  #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+    static millis_t next_isr_limits_ms = 0;
+    if (ELAPSED(millis(), next_isr_limits_ms)) {
+      next_isr_limits_ms = millis() + 500UL;
+      stepper.update_isr_limits();
+    }
+  #endif
+
+  #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+    stepper.prepare_step_schedule();
+  #endif
+
   ui.update();
 
   #if ENABLED(HOST_KEEPALIVE_FEATURE)
@@ -708,6 +738,10 @@ void idle(
   #if ENABLED(POLL_JOG)
     joystick.inject_jog_moves();
   #endif
+
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.idle_end();
+  #endif
 }
 
 /**
@@ -572,10 +572,10 @@ void Max7219::idle_tasks() {
   #if MAX7219_USE_HEAD || MAX7219_USE_TAIL
     CRITICAL_SECTION_START;
     #if MAX7219_USE_HEAD
-      const uint8_t head = planner.block_buffer_head;
+      const block_index_t head = planner.block_buffer_head;
     #endif
     #if MAX7219_USE_TAIL
-      const uint8_t tail = planner.block_buffer_tail;
+      const block_index_t tail = planner.block_buffer_tail;
     #endif
     CRITICAL_SECTION_END;
   #endif
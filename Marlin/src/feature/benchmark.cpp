@@ -0,0 +1,338 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2019 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(MOTION_BENCHMARK)
+
+#include "benchmark.h"
+#include "../gcode/queue.h"
+#include "../module/planner.h"
+
+MotionBenchmark benchmark;
+
+volatile bool MotionBenchmark::input_done, MotionBenchmark::syncing;
+
+uint32_t MotionBenchmark::blocks_planned;
+uint64_t MotionBenchmark::plan_cycles;
+uint32_t MotionBenchmark::reverse_pass_blocks,
+         MotionBenchmark::forward_pass_blocks,
+         MotionBenchmark::trapezoid_blocks;
+
+uint64_t MotionBenchmark::step_events, MotionBenchmark::isr_cycles;
+uint32_t MotionBenchmark::isr_calls, MotionBenchmark::block_phase_max;
+
+uint32_t MotionBenchmark::starvations;
+
+uint32_t MotionBenchmark::serial_bytes;
+
+uint32_t MotionBenchmark::dispatches;
+uint64_t MotionBenchmark::dispatch_cycles;
+
+#if ENABLED(SEGMENT_COALESCING)
+  uint32_t MotionBenchmark::segments_coalesced;
+#endif
+
+#if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+  uint32_t MotionBenchmark::scheduled_blocks, MotionBenchmark::scheduled_intervals;
+#endif
+
+#if ENABLED(GCODE_DECIMAL_SCANNER)
+
+  uint32_t MotionBenchmark::numbers_scanned, MotionBenchmark::numbers_inexact, MotionBenchmark::number_error;
+
+  /**
+   * Read the same number with strtod and count
+   * the floats between the two results.
+   */
+  void MotionBenchmark::compare_float(const char *p, const float f) {
+    char num[24];
+    uint8_t n = 0;
+    while (n < sizeof(num) - 1 && DECIMAL_SIGNED(p[n])) { num[n] = p[n]; n++; }
+    num[n] = '\0';
+    const float ref = strtod(num, nullptr);
+    numbers_scanned++;
+    if (f == ref) return;
+    int32_t a, b;
+    memcpy(&a, &f, sizeof(a));
+    memcpy(&b, &ref, sizeof(b));
+    numbers_inexact++;
+    NOLESS(number_error, uint32_t(ABS(a - b)));
+  }
+
+#endif
+
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+  uint32_t MotionBenchmark::preparsed_commands, MotionBenchmark::text_commands;
+#endif
+
+float MotionBenchmark::move_distance, MotionBenchmark::nominal_time;
+uint64_t MotionBenchmark::lookahead_sum;
+
+#if ENABLED(PLANNER_FIXED_POINT)
+  uint32_t MotionBenchmark::trapezoids_compared,
+           MotionBenchmark::trapezoid_rate_error,
+           MotionBenchmark::trapezoid_step_error;
+#endif
+
+#if ENABLED(S_CURVE_ACCELERATION)
+  uint32_t MotionBenchmark::bezier_evals, MotionBenchmark::bezier_error;
+#endif
+
+#if ENABLED(LIN_ADVANCE)
+  uint32_t MotionBenchmark::advance_blocks, MotionBenchmark::advance_lag_sum, MotionBenchmark::advance_lag_max;
+#endif
+
+#if ENABLED(INPUT_SHAPING)
+
+  uint32_t MotionBenchmark::shaping_holds;
+
+  /**
+   * The X / Y carriages as a mass on a spring (BENCHMARK_RESONANCE_FREQ / _DAMPING)
+   * pulled along by the steps. Between two steps the stepper stands still, so the
+   * deflection is a free damped oscillation and can be advanced exactly. When an axis
+   * has rested for a while the amplitude it had at its last step is the ringing left
+   * over from the move before.
+   */
+  struct resonator_t {
+    double deflection, rate;    // Carriage minus stepper position (mm, mm/s)
+    uint32_t last_tick;
+    bool moved;
+    double ringing_max, ringing_sum;
+    uint32_t stops;
+  };
+  static resonator_t resonator[2];
+
+  void MotionBenchmark::shaped_step(const AxisEnum axis, const int8_t dir, const uint32_t tick) {
+    constexpr double w = 2 * M_PI * (BENCHMARK_RESONANCE_FREQ),
+                     zeta = BENCHMARK_RESONANCE_DAMPING,
+                     zw = zeta * w,
+                     rest_time = 0.1;  // (s) Standstill long enough to count as a stop
+    const double wd = w * sqrt(1 - zeta * zeta);
+
+    resonator_t &r = resonator[axis];
+    const double dt = double(tick - r.last_tick) / (STEPPER_TIMER_RATE);
+    r.last_tick = tick;
+
+    if (r.moved && dt > rest_time) {
+      const double b = (r.rate + zw * r.deflection) / wd,
+                   amplitude = sqrt(sq(r.deflection) + sq(b)) * 1000;
+      NOLESS(r.ringing_max, amplitude);
+      r.ringing_sum += amplitude;
+      r.stops++;
+    }
+
+    // Free oscillation since the last step
+    const double b = (r.rate + zw * r.deflection) / wd,
+                 decay = exp(-zw * dt), c = cos(wd * dt), s = sin(wd * dt);
+    const double e = decay * (r.deflection * c + b * s);
+    r.rate = decay * (r.rate * c - (zw * b + wd * r.deflection) * s);
+    r.deflection = e;
+
+    // The stepper moves, the carriage hasn't yet
+    r.deflection -= dir * planner.steps_to_mm[axis];
+    r.moved = true;
+  }
+
+#endif
+
+bool MotionBenchmark::moving;
+uint64_t MotionBenchmark::plan_started, MotionBenchmark::plan_isr_mark,
+         MotionBenchmark::isr_started, MotionBenchmark::isr_events_mark,
+         MotionBenchmark::block_phase_started,
+         MotionBenchmark::first_move, MotionBenchmark::last_move;
+
+/**
+ * Called by the block phase when it starts executing a block.
+ * E-only moves are left out of the feedrate figures.
+ */
+void MotionBenchmark::block_started(const block_t &block) {
+  if (!first_move) first_move = now();
+  moving = true;
+  lookahead_sum += planner.movesplanned();
+  if (!(block.steps.x || block.steps.y || block.steps.z)) return;
+  move_distance += block.millimeters;
+  nominal_time += block.millimeters / SQRT(block.nominal_speed_sqr);
+}
+
+/**
+ * Called by the block phase when it finds no block to execute.
+ * Running dry between two blocks while G-code is still waiting to be
+ * planned (and no M400 / G4 style sync is in progress) counts as starvation.
+ */
+void MotionBenchmark::block_missed() {
+  if (!moving) return;
+  moving = false;
+  last_move = now();
+  if (!syncing && (!input_done || queue.has_commands_queued())) {
+    starvations++;
+    #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+      const int8_t slot = running;
+      if (slot >= 0) profile[slot].starvations++; else idle_starvations++;
+    #endif
+  }
+}
+
+#if ENABLED(BENCHMARK_COMMAND_PROFILE)
+
+  MotionBenchmark::command_profile_t MotionBenchmark::profile[64];
+  uint8_t MotionBenchmark::profiled;
+  volatile int8_t MotionBenchmark::running = -1;
+  uint32_t MotionBenchmark::idle_starvations;
+  uint8_t MotionBenchmark::idle_depth;
+  uint64_t MotionBenchmark::idle_cycles, MotionBenchmark::idle_started, MotionBenchmark::idle_interrupt_mark;
+  thread_local uint64_t MotionBenchmark::interrupt_cycles, MotionBenchmark::interrupt_started;
+  thread_local uint8_t MotionBenchmark::interrupt_depth;
+
+  MotionBenchmark::command_mark_t MotionBenchmark::command_start(const char letter, const uint16_t codenum) {
+    int8_t slot = -1;
+    for (uint8_t i = 0; i < profiled; i++)
+      if (profile[i].letter == letter && profile[i].codenum == codenum) { slot = i; break; }
+    if (slot < 0 && profiled < COUNT(profile)) {
+      slot = profiled++;
+      profile[slot].letter = letter;
+      profile[slot].codenum = codenum;
+    }
+    const command_mark_t mark = { cpu_now(), idle_cycles, interrupt_cycles, slot, running };
+    if (slot >= 0) running = slot;
+    return mark;
+  }
+
+  void MotionBenchmark::command_end(const command_mark_t &mark) {
+    running = mark.outer;
+    if (mark.slot < 0) return;
+    command_profile_t &p = profile[mark.slot];
+    const uint64_t waited = idle_cycles - mark.idle_mark,
+                   spent = excluding(mark.started, mark.interrupt_mark),
+                   cycles = spent > waited ? spent - waited : 0;
+    p.calls++;
+    p.cycles += cycles;
+    p.wait_cycles += waited;
+    NOLESS(p.max_cycles, cycles);
+  }
+
+  // Codes by total time, most expensive first
+  void MotionBenchmark::report_profile() {
+    uint8_t order[COUNT(profile)];
+    LOOP_L_N(i, profiled) {
+      uint8_t j = i;
+      for (; j && profile[order[j - 1]].cycles < profile[i].cycles; j--) order[j] = order[j - 1];
+      order[j] = i;
+    }
+    SERIAL_ECHOLNPGM("  Command profile (host CPU cycles in the handler, idle() and ISRs excluded):");
+    LOOP_L_N(i, profiled) {
+      const command_profile_t &p = profile[order[i]];
+      SERIAL_ECHOPGM("    ");
+      SERIAL_CHAR(p.letter);
+      SERIAL_ECHO(p.codenum);
+      SERIAL_ECHOLNPAIR(": ", p.calls, " calls, ", p.cycles, " total (", float(p.cycles) / (F_CPU),
+        "s), ", p.calls ? float(p.cycles) / p.calls : 0.0f, " avg, ", p.max_cycles, " max, ",
+        float(p.wait_cycles) / (F_CPU), "s waiting, ", p.starvations, " starved");
+    }
+    SERIAL_ECHOLNPAIR("    Between commands: ", idle_starvations, " starved");
+  }
+
+#endif // BENCHMARK_COMMAND_PROFILE
+
+#if ENABLED(PLANNER_FIXED_POINT)
+
+  static inline uint32_t abs_diff(const uint32_t a, const uint32_t b) { return a > b ? a - b : b - a; }
+
+  void MotionBenchmark::compare_trapezoid(const block_t &fixed, const block_t &ref) {
+    trapezoids_compared++;
+    NOLESS(trapezoid_rate_error, abs_diff(fixed.initial_rate, ref.initial_rate));
+    NOLESS(trapezoid_rate_error, abs_diff(fixed.final_rate, ref.final_rate));
+    #if ENABLED(S_CURVE_ACCELERATION)
+      NOLESS(trapezoid_rate_error, abs_diff(fixed.cruise_rate, ref.cruise_rate));
+    #endif
+    NOLESS(trapezoid_step_error, abs_diff(fixed.accelerate_until, ref.accelerate_until));
+    NOLESS(trapezoid_step_error, abs_diff(fixed.decelerate_after, ref.decelerate_after));
+  }
+
+#endif
+
+bool MotionBenchmark::finished() {
+  return input_done && !queue.has_commands_queued() && !planner.has_blocks_queued();
+}
+
+void MotionBenchmark::report() {
+  const float cpu_mhz = float(F_CPU) / 1000000.0f;
+
+  SERIAL_ECHOLNPGM("Motion benchmark:");
+  SERIAL_ECHOPAIR("  Serial input: ", serial_bytes, " bytes");
+  #if BENCHMARK_SERIAL_BAUD
+    SERIAL_ECHOPAIR(" at ", BENCHMARK_SERIAL_BAUD, " baud (", serial_bytes * 10.0f / (BENCHMARK_SERIAL_BAUD), "s)");
+  #endif
+  SERIAL_EOL();
+  SERIAL_ECHOLNPAIR("  Blocks planned: ", blocks_planned,
+    " (", plan_cycles ? float(blocks_planned) * (F_CPU) / plan_cycles : 0.0f, " blocks/s)");
+  #if ENABLED(SEGMENT_COALESCING)
+    SERIAL_ECHOLNPAIR("  Segments coalesced: ", segments_coalesced);
+  #endif
+  #if ENABLED(GCODE_DECIMAL_SCANNER)
+    SERIAL_ECHOLNPAIR("  Numbers scanned: ", numbers_scanned, " (", numbers_inexact, " differ from strtod, max ", number_error, " ulp)");
+  #endif
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    SERIAL_ECHOLNPAIR("  Queued commands: ", preparsed_commands, " pre-parsed, ", text_commands, " from text");
+  #endif
+  SERIAL_ECHOLNPAIR("  Dispatch cycles/command: ", dispatches ? float(dispatch_cycles) / (float(dispatches) * dispatch_batch) : 0.0f);
+  SERIAL_ECHOLNPAIR("  Planner cycles/block: ", blocks_planned ? float(plan_cycles) / blocks_planned : 0.0f);
+  if (blocks_planned) {
+    const float bp = blocks_planned;
+    SERIAL_ECHOLNPAIR("  Blocks replanned per block: reverse ", reverse_pass_blocks / bp,
+      " forward ", forward_pass_blocks / bp, " trapezoids ", trapezoid_blocks / bp);
+    SERIAL_ECHOLNPAIR("  Average look-ahead: ", lookahead_sum / bp, " blocks");
+  }
+  SERIAL_ECHOLNPAIR("  Step events: ", step_events, " in ", isr_calls, " ISRs");
+  #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+    SERIAL_ECHOLNPAIR("  Step schedule: ", scheduled_blocks, " blocks, ", scheduled_intervals, " intervals precomputed");
+  #endif
+  SERIAL_ECHOLNPAIR("  ISR cycles/step: ", step_events ? float(isr_cycles) / step_events : 0.0f);
+  SERIAL_ECHOLNPAIR("  Block phase worst case: ", block_phase_max, " cycles (", block_phase_max / cpu_mhz, "us)");
+  SERIAL_ECHOLNPAIR("  Planner starvation events: ", starvations);
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    report_profile();
+  #endif
+  #if ENABLED(PLANNER_FIXED_POINT)
+    SERIAL_ECHOLNPAIR("  Fixed-point trapezoids: ", trapezoids_compared,
+      " max error: ", trapezoid_rate_error, " steps/s ", trapezoid_step_error, " steps");
+  #endif
+  #if ENABLED(S_CURVE_ACCELERATION)
+    SERIAL_ECHOLNPAIR("  Bezier evaluations: ", bezier_evals, " max Horner error: ", bezier_error, " steps/s");
+  #endif
+  #if ENABLED(LIN_ADVANCE)
+    SERIAL_ECHOLNPAIR("  Advance lag at block end: average ", advance_blocks ? float(advance_lag_sum) / advance_blocks : 0.0f,
+      " max ", advance_lag_max, " steps over ", advance_blocks, " blocks");
+  #endif
+  #if ENABLED(INPUT_SHAPING)
+    SERIAL_ECHOLNPAIR("  Shaping holds: ", shaping_holds);
+    LOOP_L_N(a, 2) {
+      const resonator_t &r = resonator[a];
+      SERIAL_ECHOLNPAIR("  Ringing ", axis_codes[a], ": max ", r.ringing_max, "um, average ",
+        r.stops ? r.ringing_sum / r.stops : 0.0, "um over ", r.stops, " stops");
+    }
+  #endif
+  const float motion_time = float(last_move - first_move) / (F_CPU);
+  SERIAL_ECHOLNPAIR("  Motion time: ", motion_time, "s");
+  if (motion_time > 0)
+    SERIAL_ECHOLNPAIR("  Average feedrate: ", move_distance / motion_time, "mm/s (",
+      100.0f * nominal_time / motion_time, "% of programmed) with ", int(BLOCK_BUFFER_SIZE), " blocks");
+}
+
+#endif // MOTION_BENCHMARK
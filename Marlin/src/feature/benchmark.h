@@ -0,0 +1,214 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2019 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * feature/benchmark.h
+ * Planner / Stepper throughput counters for the Linux native simulator.
+ *
+ * All times are taken from the simulated Clock and expressed in F_CPU cycles,
+ * so results are comparable between runs made with the same time multiplier.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(BENCHMARK_COMMAND_PROFILE)
+  #include <time.h>
+#endif
+
+struct block_t;
+
+class MotionBenchmark {
+public:
+  static volatile bool input_done,      // The G-code source reached EOF
+                       syncing;         // Planner::synchronize is draining the buffer on purpose
+
+  static uint32_t blocks_planned;       // Blocks added by Planner::_buffer_steps
+  static uint64_t plan_cycles;          // Cycles spent planning them (ISR time excluded)
+  static uint32_t reverse_pass_blocks,  // Blocks visited by the look-ahead passes
+                  forward_pass_blocks,
+                  trapezoid_blocks;     // Blocks scanned by recalculate_trapezoids
+
+  static uint64_t step_events,          // Step events generated by the pulse phase
+                  isr_cycles;           // Cycles spent in Stepper::isr() calls that produced steps
+  static uint32_t isr_calls,            // Number of those calls
+                  block_phase_max;      // Worst-case stepper_block_phase_isr() cycles
+
+  static uint32_t starvations;          // Planner ran dry while more G-code was pending
+
+  static uint32_t serial_bytes;         // Bytes of input delivered to the serial port
+
+  static constexpr uint8_t dispatch_batch = 100; // Handler lookups timed together for each command
+  static uint32_t dispatches;           // Commands looked up in the dispatch table
+  static uint64_t dispatch_cycles;      // Cycles spent on those lookups
+  static inline void dispatch_done(const uint64_t cycles) { dispatches++; dispatch_cycles += cycles; }
+
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    // GcodeSuite::process_parsed_command, which may run nested commands
+    struct command_mark_t { uint64_t started, idle_mark, interrupt_mark; int8_t slot, outer; };
+    static command_mark_t command_start(const char letter, const uint16_t codenum);
+    static void command_end(const command_mark_t &mark);
+
+    // idle(), where commands wait for the planner, heaters, etc.
+    static uint64_t idle_cycles;
+    static inline void idle_start() {
+      if (!idle_depth++) { idle_started = cpu_now(); idle_interrupt_mark = interrupt_cycles; }
+    }
+    static inline void idle_end() {
+      if (!--idle_depth) idle_cycles += excluding(idle_started, idle_interrupt_mark);
+    }
+
+    // Timer ISRs, which the simulator runs as signal handlers on whichever thread takes the signal
+    static thread_local uint64_t interrupt_cycles;
+    static inline void interrupt_start() { if (!interrupt_depth++) interrupt_started = cpu_now(); }
+    static inline void interrupt_end() { if (!--interrupt_depth) interrupt_cycles += cpu_now() - interrupt_started; }
+
+    // CPU time since 'started' less the ISR time since 'interrupt_mark'. An ISR that lands
+    // between the two reads is left in, so the result can't underflow.
+    static inline uint64_t excluding(const uint64_t started, const uint64_t interrupt_mark) {
+      const uint64_t interrupts = interrupt_cycles - interrupt_mark;
+      return cpu_now() - started - interrupts;
+    }
+
+    // CPU time of the calling thread, so other simulator threads sharing the core don't count
+    static inline uint64_t cpu_now() {
+      timespec ts;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+      return uint64_t(ts.tv_sec) * (F_CPU) + uint64_t(ts.tv_nsec) * (F_CPU) / 1000000000UL;
+    }
+  #endif
+
+  #if ENABLED(SEGMENT_COALESCING)
+    static uint32_t segments_coalesced; // Segments merged into the move before them
+  #endif
+
+  #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+    static uint32_t scheduled_blocks,   // Blocks started with a step schedule that still matched
+                    scheduled_intervals; // Block phase intervals taken from the schedule
+  #endif
+
+  #if ENABLED(GCODE_DECIMAL_SCANNER)
+    static uint32_t numbers_scanned,    // Values read by GCodeParser::scan_float
+                    numbers_inexact,    // Values that differ from strtod
+                    number_error;       // Largest difference (units in the last place)
+    static void compare_float(const char *p, const float f);
+  #endif
+
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    static uint32_t preparsed_commands, // Queued commands run from their parsed values
+                    text_commands;      // Queued commands parsed from text when run
+  #endif
+
+  static float move_distance,           // Total length of XYZ moves executed (mm)
+               nominal_time;            // Time those moves take at their nominal feedrate (s)
+  static uint64_t lookahead_sum;        // Sum of queued blocks seen as each block starts
+
+  #if ENABLED(PLANNER_FIXED_POINT)
+    static uint32_t trapezoids_compared,  // Fixed-point trapezoids checked against the float version
+                    trapezoid_rate_error, // Largest difference in initial / final rate (steps/s)
+                    trapezoid_step_error; // Largest difference in accelerate_until / decelerate_after
+    static void compare_trapezoid(const block_t &fixed, const block_t &ref);
+  #endif
+
+  #if ENABLED(S_CURVE_ACCELERATION)
+    static uint32_t bezier_evals,         // Bézier speed evaluations checked against the Horner / DSP version
+                    bezier_error;         // Largest difference between them (steps/s)
+    static inline void compare_bezier(const int32_t ref, const int32_t horner) {
+      bezier_evals++;
+      NOLESS(bezier_error, uint32_t(ABS(ref - horner)));
+    }
+  #endif
+
+  #if ENABLED(LIN_ADVANCE)
+    static uint32_t advance_blocks,       // Blocks with Linear Advance finished
+                    advance_lag_sum,      // Sum and largest distance from the advance they should end with (steps)
+                    advance_lag_max;
+    static inline void advance_done(const uint16_t current, const uint16_t target) {
+      const uint32_t lag = ABS(int32_t(current) - int32_t(target));
+      advance_blocks++;
+      advance_lag_sum += lag;
+      NOLESS(advance_lag_max, lag);
+    }
+  #endif
+
+  #if ENABLED(INPUT_SHAPING)
+    static uint32_t shaping_holds;        // Main ISR passes held back by full shaping queues
+    // X / Y step output by the shaper, at 'tick' stepper timer ticks
+    static void shaped_step(const AxisEnum axis, const int8_t dir, const uint32_t tick);
+  #endif
+
+  static inline uint64_t now() { return Clock::ticks(); }
+
+  static void report();
+
+  // Planner::_buffer_steps
+  static inline void plan_start() { plan_started = now(); plan_isr_mark = isr_cycles; }
+  static inline void plan_end() {
+    plan_cycles += (now() - plan_started) - (isr_cycles - plan_isr_mark);
+    blocks_planned++;
+  }
+
+  // Stepper::isr
+  static inline void isr_start() { isr_started = now(); isr_events_mark = step_events; }
+  static inline void isr_end() {
+    if (step_events == isr_events_mark) return;
+    isr_cycles += now() - isr_started;
+    isr_calls++;
+  }
+
+  // Stepper::stepper_block_phase_isr
+  static inline void block_phase_start() { block_phase_started = now(); }
+  static inline void block_phase_end() {
+    const uint32_t cycles = now() - block_phase_started;
+    NOLESS(block_phase_max, cycles);
+  }
+  static void block_started(const block_t &block);
+  static void block_missed();
+
+  // True once the G-code source is exhausted and all motion is complete
+  static bool finished();
+
+private:
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    struct command_profile_t {
+      char letter;
+      uint16_t codenum;
+      uint32_t calls, starvations;
+      uint64_t cycles, max_cycles,      // CPU time in the handler, idle() excluded
+               wait_cycles;             // CPU time in idle(), ISRs excluded
+    };
+    static command_profile_t profile[64];
+    static uint8_t profiled;            // Codes in the profile
+    static volatile int8_t running;     // Profile slot of the innermost running command, or -1
+    static uint32_t idle_starvations;   // Planner ran dry between commands
+    static uint8_t idle_depth;
+    static uint64_t idle_started, idle_interrupt_mark;
+    static thread_local uint8_t interrupt_depth;
+    static thread_local uint64_t interrupt_started;
+    static void report_profile();
+  #endif
+
+  static bool moving;
+  static uint64_t plan_started, plan_isr_mark,
+                  isr_started, isr_events_mark,
+                  block_phase_started,
+                  first_move, last_move;
+};
+
+extern MotionBenchmark benchmark;
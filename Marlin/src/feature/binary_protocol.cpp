@@ -22,15 +22,133 @@
 
 #include "../inc/MarlinConfigPre.h"
 
-#if ENABLED(BINARY_FILE_TRANSFER)
+#if HAS_BINARY_STREAM
 
-#include "../sd/cardreader.h"
+#if ENABLED(BINARY_FILE_TRANSFER)
+  #include "../sd/cardreader.h"
+#endif
+#if ENABLED(BINARY_GCODE_STREAMING)
+  #include "../gcode/queue.h"
+#endif
 #include "binary_protocol.h"
 
-char* SDFileTransferProtocol::Packet::Open::data = nullptr;
-size_t SDFileTransferProtocol::data_waiting, SDFileTransferProtocol::transfer_timeout, SDFileTransferProtocol::idle_timeout;
-bool SDFileTransferProtocol::transfer_active, SDFileTransferProtocol::dummy_transfer, SDFileTransferProtocol::compression;
+#if ENABLED(BINARY_FILE_TRANSFER)
+  char* SDFileTransferProtocol::Packet::Open::data = nullptr;
+  size_t SDFileTransferProtocol::data_waiting, SDFileTransferProtocol::transfer_timeout, SDFileTransferProtocol::idle_timeout;
+  bool SDFileTransferProtocol::transfer_active, SDFileTransferProtocol::dummy_transfer, SDFileTransferProtocol::compression;
+#endif
+
+#if ENABLED(BINARY_GCODE_STREAMING)
+
+  const uint8_t *BinaryGcodeProtocol::next, *BinaryGcodeProtocol::end;
+
+  void BinaryGcodeProtocol::process(uint8_t packet_type) {
+    switch (static_cast<GcodeStream>(packet_type)) {
+      case GcodeStream::QUERY:
+        SERIAL_ECHOLNPAIR("PGC:version:", VERSION_MAJOR, ".", VERSION_MINOR, ".", VERSION_PATCH, ":line:", MAX_CMD_SIZE);
+        break;
+      default:
+        SERIAL_ECHOLNPGM("PGC:invalid");
+        break;
+    }
+  }
+
+  bool BinaryGcodeProtocol::queue_commands(const int8_t port) {
+    char line[MAX_CMD_SIZE];
+    while (next < end) {
+      if (!queue.has_space()) return false;
+      const uint8_t *p = next;
+      if (!decode(p, line)) {
+        SERIAL_ECHO_MSG("Datastream G-code invalid");
+        break;  // drop the rest of the packet
+      }
+      if (line[0] != ';') queue.enqueue_decoded(line, port);
+      next = p;
+    }
+    next = end = nullptr;
+    return true;
+  }
+
+  /**
+   * Decode the command at 'p' into a line of text and advance 'p'.
+   * Return false if the command is malformed or longer than a line.
+   */
+  bool BinaryGcodeProtocol::decode(const uint8_t* &p, char (&line)[MAX_CMD_SIZE]) {
+    char *out = line;
+    const char * const out_end = line + sizeof(line) - 1;
+
+    auto get_varint = [&](uint32_t &v) {
+      v = 0;
+      for (uint8_t shift = 0; shift < 32; shift += 7) {
+        if (p >= end) return false;
+        const uint8_t b = *p++;
+        v |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+      }
+      return false;
+    };
+
+    auto put_number = [&](uint32_t v, const uint8_t places) {
+      char digits[11];
+      uint8_t n = 0;
+      do { digits[n++] = '0' + v % 10; v /= 10; } while (v || n <= places);
+      if (out + n + (places ? 1 : 0) > out_end) return false;
+      while (n) {
+        if (n == places) *out++ = '.';
+        *out++ = digits[--n];
+      }
+      return true;
+    };
+
+    if (p >= end) return false;
+    const uint8_t head = *p++;
+
+    if ((head >> 6) == 3) {               // Text
+      while (p < end && *p) {
+        if (out >= out_end) return false;
+        *out++ = *p++;
+      }
+      if (p >= end) return false;
+      p++;
+      *out = '\0';
+      return out > line;
+    }
+
+    uint32_t v;
+    *out++ = (head >> 6) == 0 ? 'G' : (head >> 6) == 1 ? 'M' : 'T';
+    if (!get_varint(v) || !put_number(v, 0)) return false;
+    if (TEST(head, 5)) {
+      if (p >= end || out + 2 > out_end) return false;
+      *out++ = '.';
+      if (!put_number(*p++, 0)) return false;
+    }
+
+    for (uint8_t i = head & 0x1F; i--;) {
+      if (p >= end || out + 2 > out_end) return false;
+      const uint8_t param = *p++, letter = param & 0x1F, kind = param >> 5;
+      if (letter > 'Z' - 'A') return false;
+      *out++ = ' ';
+      *out++ = 'A' + letter;
+      if (!kind) continue;
+      if (!get_varint(v)) return false;
+      if (v & 1) {                        // zigzag: odd values are negative
+        if (out >= out_end) return false;
+        *out++ = '-';
+      }
+      if (!put_number((v >> 1) + (v & 1), kind - 1)) return false;
+    }
+
+    *out = '\0';
+    return true;
+  }
+
+#endif // BINARY_GCODE_STREAMING
+
+bool BinaryStream::active;
+#if NUM_SERIAL > 1
+  int8_t BinaryStream::port;
+#endif
 
 BinaryStream binaryStream[NUM_SERIAL];
 
-#endif // BINARY_FILE_TRANSFER
+#endif // HAS_BINARY_STREAM
@@ -23,7 +23,9 @@
 
 #include "../inc/MarlinConfig.h"
 
-#define BINARY_STREAM_COMPRESSION
+#if ENABLED(BINARY_FILE_TRANSFER)
+  #define BINARY_STREAM_COMPRESSION
+#endif
 
 #if ENABLED(BINARY_STREAM_COMPRESSION)
   #include "../libs/heatshrink/heatshrink_decoder.h"
@@ -54,6 +56,8 @@ inline int bs_read_serial(const uint8_t index) {
   static uint8_t decode_buffer[512] = {};
 #endif
 
+#if ENABLED(BINARY_FILE_TRANSFER)
+
 class SDFileTransferProtocol  {
 private:
   struct Packet {
@@ -218,14 +222,65 @@ public:
   static const uint16_t VERSION_MAJOR = 0, VERSION_MINOR = 1, VERSION_PATCH = 0, TIMEOUT = 10000, IDLE_PERIOD = 1000;
 };
 
+#endif // BINARY_FILE_TRANSFER
+
+#if ENABLED(BINARY_GCODE_STREAMING)
+
+/**
+ * G-code packets hold a run of encoded commands, each one being either
+ *
+ *   Text    0xC0, then the line of text up to a '\0'
+ *   Code    Head byte:  bits 7-6  0 = G, 1 = M, 2 = T
+ *                       bit 5     a subcode byte follows the code number
+ *                       bits 4-0  number of parameters
+ *           Code number (varint), subcode byte if flagged, then each parameter:
+ *             Head byte:  bits 7-5  0 = no value, 1 = integer, 2-7 = decimal with 1-6 places
+ *                         bits 4-0  letter - 'A'
+ *             Value (zigzag varint) of integers and decimals, the latter as 10^places times the value
+ *
+ * Varints hold 7 bits per byte, low bits first, with bit 7 set on all but the last byte.
+ * The commands are turned back into text and queued, so they run like any other.
+ */
+class BinaryGcodeProtocol {
+public:
+  enum class GcodeStream : uint8_t { QUERY, COMMANDS };
+
+  static void process(uint8_t packet_type);
+
+  // Begin queueing the commands of a received packet
+  static inline void start(const char* buffer, const uint16_t length) {
+    next = reinterpret_cast<const uint8_t*>(buffer);
+    end = next + length;
+  }
+
+  // Queue the packet's commands while there's room. True once all are queued.
+  static bool queue_commands(const int8_t port);
+
+  static const uint16_t VERSION_MAJOR = 0, VERSION_MINOR = 1, VERSION_PATCH = 0;
+
+private:
+  static const uint8_t *next, *end;
+  static bool decode(const uint8_t* &p, char (&line)[MAX_CMD_SIZE]);
+};
+
+#endif // BINARY_GCODE_STREAMING
+
 class BinaryStream {
 public:
-  enum class Protocol : uint8_t { CONTROL, FILE_TRANSFER };
+  enum class Protocol : uint8_t { CONTROL, FILE_TRANSFER, GCODE };
 
   enum class ProtocolControl : uint8_t { SYNC = 1, CLOSE };
 
   enum class StreamState : uint8_t { PACKET_RESET, PACKET_WAIT, PACKET_HEADER, PACKET_DATA, PACKET_FOOTER,
-                                     PACKET_PROCESS, PACKET_RESEND, PACKET_TIMEOUT, PACKET_ERROR };
+                                     PACKET_PROCESS, PACKET_QUEUE, PACKET_RESEND, PACKET_TIMEOUT, PACKET_ERROR };
+
+  // The stream replaces ASCII input on one serial port after M28 B1
+  static bool active;
+  #if NUM_SERIAL > 1
+    static int8_t port;
+  #else
+    static constexpr int8_t port = 0;
+  #endif
 
   struct Packet { // 10 byte protocol overhead, ascii with checksum and line number has a minimum of 7 increasing with line
 
@@ -291,8 +346,8 @@ public:
       stream_state = StreamState::PACKET_TIMEOUT;
       return false;
     }
-    if (!bs_serial_data_available(card.transfer_port_index)) return false;
-    data = bs_read_serial(card.transfer_port_index);
+    if (!bs_serial_data_available(port)) return false;
+    data = bs_read_serial(port);
     packet.timeout = millis() + PACKET_MAX_WAIT;
     return true;
   }
@@ -302,9 +357,7 @@ public:
     uint8_t data = 0;
     millis_t transfer_window = millis() + RX_TIMESLICE;
 
-    #if ENABLED(SDSUPPORT)
-      PORT_REDIRECT(card.transfer_port_index);
-    #endif
+    PORT_REDIRECT(port);
 
     #pragma GCC diagnostic push
     #pragma GCC diagnostic ignored "-Warray-bounds"
@@ -416,10 +469,28 @@ public:
           packet_retries = 0;
           bytes_received += packet.header.size;
 
+          #if ENABLED(BINARY_GCODE_STREAMING)
+            // Commands are acknowledged once they're all queued, for flow control
+            if (static_cast<Protocol>(packet.header.protocol()) == Protocol::GCODE
+              && static_cast<BinaryGcodeProtocol::GcodeStream>(packet.header.type()) == BinaryGcodeProtocol::GcodeStream::COMMANDS
+            ) {
+              BinaryGcodeProtocol::start(packet.buffer, packet.header.size);
+              stream_state = StreamState::PACKET_QUEUE;
+              break;
+            }
+          #endif
+
           SERIAL_ECHOLNPAIR("ok", packet.header.sync); // transmit valid packet received
           dispatch();
           stream_state = StreamState::PACKET_RESET;
           break;
+        case StreamState::PACKET_QUEUE:
+          #if ENABLED(BINARY_GCODE_STREAMING)
+            if (!BinaryGcodeProtocol::queue_commands(port)) return; // the queue is full, continue later
+            SERIAL_ECHOLNPAIR("ok", packet.header.sync);
+          #endif
+          stream_state = StreamState::PACKET_RESET;
+          break;
         case StreamState::PACKET_RESEND:
           if (packet_retries < MAX_RETRIES || MAX_RETRIES == 0) {
             packet_retries++;
@@ -451,15 +522,22 @@ public:
       case Protocol::CONTROL:
         switch(static_cast<ProtocolControl>(packet.header.type())) {
           case ProtocolControl::CLOSE: // revert back to ASCII mode
-            card.flag.binary_mode = false;
+            active = false;
             break;
           default:
             SERIAL_ECHO_MSG("Unknown BinaryProtocolControl Packet");
         }
         break;
-      case Protocol::FILE_TRANSFER:
-        SDFileTransferProtocol::process(packet.header.type(), packet.buffer, packet.header.size); // send user data to be processed
-      break;
+      #if ENABLED(BINARY_FILE_TRANSFER)
+        case Protocol::FILE_TRANSFER:
+          SDFileTransferProtocol::process(packet.header.type(), packet.buffer, packet.header.size); // send user data to be processed
+        break;
+      #endif
+      #if ENABLED(BINARY_GCODE_STREAMING)
+        case Protocol::GCODE:
+          BinaryGcodeProtocol::process(packet.header.type());
+        break;
+      #endif
       default:
         SERIAL_ECHO_MSG("Unsupported Binary Protocol");
     }
@@ -467,7 +545,9 @@ public:
 
   void idle() {
     // Some Protocols may need periodic updates without new data
-    SDFileTransferProtocol::idle();
+    #if ENABLED(BINARY_FILE_TRANSFER)
+      SDFileTransferProtocol::idle();
+    #endif
   }
 
   static const uint16_t PACKET_MAX_WAIT = 500, RX_TIMESLICE = 20, MAX_RETRIES = 0, VERSION_MAJOR = 0, VERSION_MINOR = 1, VERSION_PATCH = 0;
@@ -0,0 +1,44 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2019 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(ADAPTIVE_MULTI_STEPPING)
+
+#include "../gcode.h"
+#include "../../module/stepper.h"
+
+/**
+ * M318 - Report the measured stepper ISR times and the step rates
+ *        at which each multi-stepping factor is used
+ *
+ *   R           - Reset the measurements to the estimated limits
+ *   S<percent>  - Share of CPU time the stepper ISR may take (10-95)
+ */
+void GcodeSuite::M318() {
+  if (parser.seen('R')) stepper.reset_isr_limits();
+  if (parser.seenval('S')) stepper.isr_load = constrain(parser.value_byte(), 10, 95);
+  if (parser.seen("RS")) stepper.update_isr_limits();
+  stepper.report_isr_limits();
+}
+
+#endif // ADAPTIVE_MULTI_STEPPING
@@ -42,5 +42,11 @@ void GcodeSuite::M999() {
 
   if (parser.boolval('S')) return;
 
-  queue.flush_and_request_resend();
+  queue.flush_and_request_resend(
+    #if NUM_SERIAL > 1
+      queue.port[queue.index_r]
+    #else
+      0
+    #endif
+  );
 }
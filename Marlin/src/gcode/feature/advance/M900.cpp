@@ -40,6 +40,7 @@
  *  K<factor>   Set current advance K factor (Slot 0).
  *  L<factor>   Set secondary advance K factor (Slot 1). Requires EXTRA_LIN_ADVANCE_K.
  *  S<0/1>      Activate slot 0 or 1. Requires EXTRA_LIN_ADVANCE_K.
+ *  W<seconds>  Set the time to smooth pressure changes over (all tools). Requires SMOOTH_LIN_ADVANCE.
  */
 void GcodeSuite::M900() {
 
@@ -53,6 +54,18 @@ void GcodeSuite::M900() {
     }
   #endif
 
+  #if ENABLED(SMOOTH_LIN_ADVANCE)
+    if (parser.seenval('W')) {
+      const float newW = parser.value_float();
+      if (WITHIN(newW, 0, 0.2f)) {
+        planner.synchronize();
+        planner.advance_smooth_time = newW;
+      }
+      else
+        SERIAL_ECHOLNPGM("?W value out of range (0-0.2).");
+    }
+  #endif
+
   #if ENABLED(EXTRA_LIN_ADVANCE_K)
 
     bool ext_slot = TEST(lin_adv_slot, tool_index);
@@ -109,6 +122,9 @@ void GcodeSuite::M900() {
           SERIAL_EOL();
         }
       #endif
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        SERIAL_ECHOLNPAIR("Advance W", planner.advance_smooth_time);
+      #endif
     }
 
   #else
@@ -134,6 +150,10 @@ void GcodeSuite::M900() {
         }
         SERIAL_EOL();
       #endif
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        SERIAL_ECHO_START();
+        SERIAL_ECHOLNPAIR("Advance W=", planner.advance_smooth_time);
+      #endif
     }
 
   #endif
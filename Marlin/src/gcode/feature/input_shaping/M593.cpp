@@ -0,0 +1,81 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2019 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../../inc/MarlinConfig.h"
+
+#if ENABLED(INPUT_SHAPING)
+
+#include "../../gcode.h"
+#include "../../../module/stepper.h"
+
+/**
+ * M593: Get or Set Input Shaping parameters
+ *  X / Y       Axis to set (both if neither is given)
+ *  F<hz>       Resonant frequency to cancel (0 = no shaping)
+ *  D<ratio>    Damping ratio of the resonance (0 - 0.99)
+ *  T<type>     Shaper type: 0 = ZV, 1 = ZVD, 2 = MZV
+ *
+ * With no parameters report the current settings.
+ */
+void GcodeSuite::M593() {
+  const bool seen_x = parser.seen('X'), seen_y = parser.seen('Y'),
+             set_x = seen_x || !seen_y, set_y = seen_y || !seen_x;
+
+  if (parser.seen('F') || parser.seen('D') || parser.seen('T')) {
+    LOOP_L_N(a, 2) {
+      if (!(a == X_AXIS ? set_x : set_y)) continue;
+      shaper_settings_t &ss = stepper.shaper_settings[a];
+      if (parser.seenval('F')) {
+        const float f = parser.value_float();
+        if (f == 0 || WITHIN(f, 1, 200))
+          ss.frequency = f;
+        else
+          SERIAL_ECHOLNPGM("?Frequency (F) must be 0 or 1-200 Hz.");
+      }
+      if (parser.seenval('D')) {
+        const float d = parser.value_float();
+        if (WITHIN(d, 0, 0.99f))
+          ss.damping = d;
+        else
+          SERIAL_ECHOLNPGM("?Damping (D) must be 0-0.99.");
+      }
+      if (parser.seenval('T')) {
+        const uint8_t t = parser.value_byte();
+        if (t <= SHAPER_MZV)
+          ss.type = (ShaperType)t;
+        else
+          SERIAL_ECHOLNPGM("?Type (T) must be 0 (ZV), 1 (ZVD) or 2 (MZV).");
+      }
+      stepper.update_shaper((AxisEnum)a);
+    }
+  }
+  else {
+    LOOP_L_N(a, 2) {
+      if (!(a == X_AXIS ? set_x : set_y)) continue;
+      const shaper_settings_t &ss = stepper.shaper_settings[a];
+      SERIAL_ECHO_START();
+      SERIAL_ECHOLNPAIR("Input shaping ", axis_codes[a], ": F", ss.frequency, " D", ss.damping, " T", int(ss.type));
+    }
+  }
+}
+
+#endif // INPUT_SHAPING
@@ -49,6 +49,14 @@ GcodeSuite gcode;
   #include "../feature/cancel_object.h"
 #endif
 
+#if ENABLED(SEGMENT_COALESCING)
+  #include "../module/planner.h"
+#endif
+
+#if ENABLED(MOTION_BENCHMARK)
+  #include "../feature/benchmark.h"
+#endif
+
 #include "../Marlin.h" // for idle() and suspend_auto_report
 
 millis_t GcodeSuite::previous_move_ms;
@@ -212,647 +220,812 @@ void GcodeSuite::dwell(millis_t time) {
   extern void M100_dump_routine(PGM_P const title, char *start, char *end);
 #endif
 
+//
+// Adapters for handlers that take arguments or send their own "ok"
+//
+static bool skip_ok; // Set by a handler that already sent "ok" or mustn't send one
+
+void GcodeSuite::noop() {}
+
+void GcodeSuite::_G0_G1() {
+  G0_G1(
+    #if IS_SCARA || defined(G0_FEEDRATE)
+      parser.codenum == 0
+    #endif
+  );
+}
+
+#if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+  void GcodeSuite::_G2_G3() { G2_G3(parser.codenum == 2); }
+#endif
+
+void GcodeSuite::_G28() { G28(false); }
+
+#if ENABLED(G38_PROBE_TARGET)
+  void GcodeSuite::_G38() {
+    if (WITHIN(parser.subcode, 2,
+      #if ENABLED(G38_PROBE_AWAY)
+        5
+      #else
+        3
+      #endif
+    )) G38(parser.subcode);
+  }
+#endif
+
+void GcodeSuite::_G90() { set_relative_mode(false); }
+void GcodeSuite::_G91() { set_relative_mode(true); }
+
+#if HAS_CUTTER
+  void GcodeSuite::_M3() { M3_M4(false); }
+  void GcodeSuite::_M4() { M3_M4(true); }
+#endif
+
+void GcodeSuite::_M105() { M105(); skip_ok = true; }
+
+#if BOTH(FWRETRACT, FWRETRACT_AUTORETRACT)
+  void GcodeSuite::_M209() { if (MIN_AUTORETRACT <= MAX_AUTORETRACT) M209(); }
+#endif
+
+#if ENABLED(MORGAN_SCARA)
+  void GcodeSuite::_M360() { skip_ok = M360(); }
+  void GcodeSuite::_M361() { skip_ok = M361(); }
+  void GcodeSuite::_M362() { skip_ok = M362(); }
+  void GcodeSuite::_M363() { skip_ok = M363(); }
+  void GcodeSuite::_M364() { skip_ok = M364(); }
+#endif
+
+template<typename T>
+constexpr bool keys_ascending(const T *entry, const size_t count) {
+  return count < 2 || (entry[0].key < entry[1].key && keys_ascending(entry + 1, count - 1));
+}
+
+#define GCODE_G(N, H) { uint16_t(N), H }
+#define GCODE_M(N, H) { uint16_t(DISPATCH_M | (N)), H }
+
 /**
- * Process the parsed command and dispatch it to its handler
+ * Find the handler for a G or M code, or nullptr if there isn't one.
+ *
+ * The table is sorted by code, which the compiler checks, so a
+ * binary search finds any entry in 8 or 9 steps from PROGMEM.
+ * Keep new entries in order, each with the guard for its handler.
  */
-void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
-  KEEPALIVE_STATE(IN_HANDLER);
+GcodeSuite::handler_t GcodeSuite::find_handler(const char letter, const uint16_t codenum) {
+  static constexpr dispatch_t table[] PROGMEM = {
+    GCODE_G(0, _G0_G1),                                           // G0: Fast Move
+    GCODE_G(1, _G0_G1),                                           // G1: Linear Move
+
+    #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+      GCODE_G(2, _G2_G3),                                         // G2: CW ARC
+      GCODE_G(3, _G2_G3),                                         // G3: CCW ARC
+    #endif
 
-  // Handle a known G, M, or T
-  switch (parser.command_letter) {
-    case 'G': switch (parser.codenum) {
-
-      case 0: case 1: G0_G1(                                      // G0: Fast Move, G1: Linear Move
-                        #if IS_SCARA || defined(G0_FEEDRATE)
-                          parser.codenum == 0
-                        #endif
-                      );
-                      break;
-
-      #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
-        case 2: case 3: G2_G3(parser.codenum == 2); break;        // G2: CW ARC, G3: CCW ARC
-      #endif
+    GCODE_G(4, G4),                                               // G4: Dwell
 
-      case 4: G4(); break;                                        // G4: Dwell
+    #if ENABLED(BEZIER_CURVE_SUPPORT)
+      GCODE_G(5, G5),                                             // G5: Cubic B_spline
+    #endif
 
-      #if ENABLED(BEZIER_CURVE_SUPPORT)
-        case 5: G5(); break;                                      // G5: Cubic B_spline
-      #endif
+    #if ENABLED(FWRETRACT)
+      GCODE_G(10, G10),                                           // G10: Retract / Swap Retract
+      GCODE_G(11, G11),                                           // G11: Recover / Swap Recover
+    #endif
 
-      #if ENABLED(FWRETRACT)
-        case 10: G10(); break;                                    // G10: Retract / Swap Retract
-        case 11: G11(); break;                                    // G11: Recover / Swap Recover
-      #endif
+    #if ENABLED(NOZZLE_CLEAN_FEATURE)
+      GCODE_G(12, G12),                                           // G12: Nozzle Clean
+    #endif
 
-      #if ENABLED(NOZZLE_CLEAN_FEATURE)
-        case 12: G12(); break;                                    // G12: Nozzle Clean
-      #endif
+    #if ENABLED(CNC_WORKSPACE_PLANES)
+      GCODE_G(17, G17),                                           // G17: Select Plane XY
+      GCODE_G(18, G18),                                           // G18: Select Plane ZX
+      GCODE_G(19, G19),                                           // G19: Select Plane YZ
+    #endif
 
-      #if ENABLED(CNC_WORKSPACE_PLANES)
-        case 17: G17(); break;                                    // G17: Select Plane XY
-        case 18: G18(); break;                                    // G18: Select Plane ZX
-        case 19: G19(); break;                                    // G19: Select Plane YZ
-      #endif
+    #if ENABLED(INCH_MODE_SUPPORT)
+      GCODE_G(20, G20),                                           // G20: Inch Mode
+      GCODE_G(21, G21),                                           // G21: MM Mode
+    #else
+      GCODE_G(21, noop),                                          // No error on unknown G21
+    #endif
 
-      #if ENABLED(INCH_MODE_SUPPORT)
-        case 20: G20(); break;                                    // G20: Inch Mode
-        case 21: G21(); break;                                    // G21: MM Mode
+    #if ENABLED(G26_MESH_VALIDATION)
+      GCODE_G(26, G26),                                           // G26: Mesh Validation Pattern generation
+    #endif
+
+    #if ENABLED(NOZZLE_PARK_FEATURE)
+      GCODE_G(27, G27),                                           // G27: Nozzle Park
+    #endif
+
+    GCODE_G(28, _G28),                                            // G28: Home all axes, one at a time
+
+    #if HAS_LEVELING
+      #if ENABLED(G29_RETRY_AND_RECOVER)
+        GCODE_G(29, G29_with_retry),                              // G29: Bed leveling calibration
       #else
-        case 21: NOOP; break;                                     // No error on unknown G21
+        GCODE_G(29, G29),                                         // G29: Bed leveling calibration
       #endif
+    #endif
 
-      #if ENABLED(G26_MESH_VALIDATION)
-        case 26: G26(); break;                                    // G26: Mesh Validation Pattern generation
-      #endif
+    #if HAS_BED_PROBE
+      GCODE_G(30, G30),                                           // G30: Single Z probe
+    #endif
 
-      #if ENABLED(NOZZLE_PARK_FEATURE)
-        case 27: G27(); break;                                    // G27: Nozzle Park
-      #endif
+    #if HAS_BED_PROBE && ENABLED(Z_PROBE_SLED)
+      GCODE_G(31, G31),                                           // G31: dock the sled
+      GCODE_G(32, G32),                                           // G32: undock the sled
+    #endif
 
-      case 28: G28(false); break;                                 // G28: Home all axes, one at a time
+    #if ENABLED(DELTA_AUTO_CALIBRATION)
+      GCODE_G(33, G33),                                           // G33: Delta Auto-Calibration
+    #endif
 
-      #if HAS_LEVELING
-        case 29:                                                  // G29: Bed leveling calibration
-          #if ENABLED(G29_RETRY_AND_RECOVER)
-            G29_with_retry();
-          #else
-            G29();
-          #endif
-          break;
-      #endif // HAS_LEVELING
-
-      #if HAS_BED_PROBE
-        case 30: G30(); break;                                    // G30: Single Z probe
-        #if ENABLED(Z_PROBE_SLED)
-          case 31: G31(); break;                                  // G31: dock the sled
-          case 32: G32(); break;                                  // G32: undock the sled
-        #endif
-      #endif
+    #if ENABLED(Z_STEPPER_AUTO_ALIGN)
+      GCODE_G(34, G34),                                           // G34: Z Stepper automatic alignment using probe
+    #endif
 
-      #if ENABLED(DELTA_AUTO_CALIBRATION)
-        case 33: G33(); break;                                    // G33: Delta Auto-Calibration
-      #endif
+    #if ENABLED(G38_PROBE_TARGET)
+      GCODE_G(38, _G38),                                          // G38.2, G38.3: Probe towards target, G38.4, G38.5: Probe away from target
+    #endif
 
-      #if ENABLED(Z_STEPPER_AUTO_ALIGN)
-        case 34: G34(); break;                                    // G34: Z Stepper automatic alignment using probe
-      #endif
+    #if HAS_MESH
+      GCODE_G(42, G42),                                           // G42: Coordinated move to a mesh point
+    #endif
 
-      #if ENABLED(G38_PROBE_TARGET)
-        case 38:                                                  // G38.2, G38.3: Probe towards target
-          if (WITHIN(parser.subcode, 2,
-            #if ENABLED(G38_PROBE_AWAY)
-              5
-            #else
-              3
-            #endif
-          )) G38(parser.subcode);                                 // G38.4, G38.5: Probe away from target
-          break;
-      #endif
+    #if ENABLED(CNC_COORDINATE_SYSTEMS)
+      GCODE_G(53, G53),                                           // G53: Move in machine coordinates
+      GCODE_G(54, G54),                                           // G54: Select workspace coordinate system
+      GCODE_G(55, G55),                                           // G55: Select workspace coordinate system
+      GCODE_G(56, G56),                                           // G56: Select workspace coordinate system
+      GCODE_G(57, G57),                                           // G57: Select workspace coordinate system
+      GCODE_G(58, G58),                                           // G58: Select workspace coordinate system
+      GCODE_G(59, G59),                                           // G59: Select workspace coordinate system
+    #endif
 
-      #if ENABLED(CNC_COORDINATE_SYSTEMS)
-        case 53: G53(); break;
-        case 54: G54(); break;
-        case 55: G55(); break;
-        case 56: G56(); break;
-        case 57: G57(); break;
-        case 58: G58(); break;
-        case 59: G59(); break;
-      #endif
+    #if ENABLED(GCODE_MOTION_MODES)
+      GCODE_G(80, G80),                                           // G80: Reset the current motion mode
+    #endif
 
-      #if ENABLED(GCODE_MOTION_MODES)
-        case 80: G80(); break;                                    // G80: Reset the current motion mode
-      #endif
+    GCODE_G(90, _G90),                                            // G90: Absolute Mode
+    GCODE_G(91, _G91),                                            // G91: Relative Mode
+    GCODE_G(92, G92),                                             // G92: Set current axis position(s)
 
-      case 90: set_relative_mode(false); break;                   // G90: Absolute Mode
-      case 91: set_relative_mode(true);  break;                   // G91: Relative Mode
+    #if ENABLED(CALIBRATION_GCODE)
+      GCODE_G(425, G425),                                         // G425: Perform calibration with calibration cube
+    #endif
 
-      case 92: G92(); break;                                      // G92: Set current axis position(s)
+    #if ENABLED(DEBUG_GCODE_PARSER)
+      GCODE_G(800, GCodeParser::debug),                           // G800: GCode Parser Test for G
+    #endif
 
-      #if HAS_MESH
-        case 42: G42(); break;                                    // G42: Coordinated move to a mesh point
-      #endif
+    #if HAS_RESUME_CONTINUE
+      GCODE_M(0, M0_M1),                                          // M0: Unconditional stop - Wait for user button press on LCD
+      GCODE_M(1, M0_M1),                                          // M1: Conditional stop - Wait for user button press on LCD
+    #endif
 
-      #if ENABLED(CALIBRATION_GCODE)
-        case 425: G425(); break;                                  // G425: Perform calibration with calibration cube
-      #endif
+    #if HAS_CUTTER
+      GCODE_M(3, _M3),                                            // M3: Turn ON Laser | Spindle (clockwise), set Power | Speed
+      GCODE_M(4, _M4),                                            // M4: Turn ON Laser | Spindle (counter-clockwise), set Power | Speed
+      GCODE_M(5, M5),                                             // M5: Turn OFF Laser | Spindle
+    #endif
 
-      #if ENABLED(DEBUG_GCODE_PARSER)
-        case 800: parser.debug(); break;                          // G800: GCode Parser Test for G
-      #endif
+    #if BOTH(COOLANT_CONTROL, COOLANT_MIST)
+      GCODE_M(7, M7),                                             // M7: Mist coolant ON
+    #endif
 
-      default: parser.unknown_command_error(); break;
-    }
-    break;
+    #if BOTH(COOLANT_CONTROL, COOLANT_FLOOD)
+      GCODE_M(8, M8),                                             // M8: Flood coolant ON
+    #endif
 
-    case 'M': switch (parser.codenum) {
+    #if ENABLED(COOLANT_CONTROL)
+      GCODE_M(9, M9),                                             // M9: Coolant OFF
+    #endif
 
-      #if HAS_RESUME_CONTINUE
-        case 0:                                                   // M0: Unconditional stop - Wait for user button press on LCD
-        case 1: M0_M1(); break;                                   // M1: Conditional stop - Wait for user button press on LCD
-      #endif
+    #if ENABLED(EXTERNAL_CLOSED_LOOP_CONTROLLER)
+      GCODE_M(12, M12),                                           // M12: Synchronize and optionally force a CLC set
+    #endif
 
-      #if HAS_CUTTER
-        case 3: M3_M4(false); break;                              // M3: Turn ON Laser | Spindle (clockwise), set Power | Speed
-        case 4: M3_M4(true ); break;                              // M4: Turn ON Laser | Spindle (counter-clockwise), set Power | Speed
-        case 5: M5(); break;                                      // M5: Turn OFF Laser | Spindle
-      #endif
+    #if ENABLED(EXPECTED_PRINTER_CHECK)
+      GCODE_M(16, M16),                                           // M16: Expected printer check
+    #endif
 
-      #if ENABLED(COOLANT_CONTROL)
-        #if ENABLED(COOLANT_MIST)
-          case 7: M7(); break;                                    // M7: Mist coolant ON
-        #endif
-        #if ENABLED(COOLANT_FLOOD)
-          case 8: M8(); break;                                    // M8: Flood coolant ON
-        #endif
-        case 9: M9(); break;                                      // M9: Coolant OFF
-      #endif
+    GCODE_M(17, M17),                                             // M17: Enable all stepper motors
+    GCODE_M(18, M18_M84),                                         // M18: Disable Steppers / Set Timeout
+
+    #if ENABLED(SDSUPPORT)
+      GCODE_M(20, M20),                                           // M20: List SD card
+      GCODE_M(21, M21),                                           // M21: Init SD card
+      GCODE_M(22, M22),                                           // M22: Release SD card
+      GCODE_M(23, M23),                                           // M23: Select file
+      GCODE_M(24, M24),                                           // M24: Start SD print
+      GCODE_M(25, M25),                                           // M25: Pause SD print
+      GCODE_M(26, M26),                                           // M26: Set SD index
+      GCODE_M(27, M27),                                           // M27: Get SD status
+    #endif
 
-      #if ENABLED(EXTERNAL_CLOSED_LOOP_CONTROLLER)
-        case 12: M12(); break;                                    // M12: Synchronize and optionally force a CLC set
-      #endif
+    #if EITHER(SDSUPPORT, BINARY_GCODE_STREAMING)
+      GCODE_M(28, M28),                                           // M28: Start SD write / binary stream
+    #endif
 
-      #if ENABLED(EXPECTED_PRINTER_CHECK)
-        case 16: M16(); break;                                    // M16: Expected printer check
-      #endif
+    #if ENABLED(SDSUPPORT)
+      GCODE_M(29, M29),                                           // M29: Stop SD write
+      GCODE_M(30, M30),                                           // M30 <filename> Delete File
+    #endif
 
-      case 17: M17(); break;                                      // M17: Enable all stepper motors
-
-      #if ENABLED(SDSUPPORT)
-        case 20: M20(); break;                                    // M20: List SD card
-        case 21: M21(); break;                                    // M21: Init SD card
-        case 22: M22(); break;                                    // M22: Release SD card
-        case 23: M23(); break;                                    // M23: Select file
-        case 24: M24(); break;                                    // M24: Start SD print
-        case 25: M25(); break;                                    // M25: Pause SD print
-        case 26: M26(); break;                                    // M26: Set SD index
-        case 27: M27(); break;                                    // M27: Get SD status
-        case 28: M28(); break;                                    // M28: Start SD write
-        case 29: M29(); break;                                    // M29: Stop SD write
-        case 30: M30(); break;                                    // M30 <filename> Delete File
-        case 32: M32(); break;                                    // M32: Select file and start SD print
-
-        #if ENABLED(LONG_FILENAME_HOST_SUPPORT)
-          case 33: M33(); break;                                  // M33: Get the long full path to a file or folder
-        #endif
-
-        #if BOTH(SDCARD_SORT_ALPHA, SDSORT_GCODE)
-          case 34: M34(); break;                                  // M34: Set SD card sorting options
-        #endif
-
-        case 928: M928(); break;                                  // M928: Start SD write
-      #endif // SDSUPPORT
-
-      case 31: M31(); break;                                      // M31: Report time since the start of SD print or last M109
-      case 42: M42(); break;                                      // M42: Change pin state
-
-      #if ENABLED(PINS_DEBUGGING)
-        case 43: M43(); break;                                    // M43: Read pin state
-      #endif
+    GCODE_M(31, M31),                                             // M31: Report time since the start of SD print or last M109
 
-      #if ENABLED(Z_MIN_PROBE_REPEATABILITY_TEST)
-        case 48: M48(); break;                                    // M48: Z probe repeatability test
-      #endif
+    #if ENABLED(SDSUPPORT)
+      GCODE_M(32, M32),                                           // M32: Select file and start SD print
+    #endif
 
-      #if ENABLED(LCD_SET_PROGRESS_MANUALLY)
-        case 73: M73(); break;                                    // M73: Set progress percentage (for display on LCD)
-      #endif
+    #if BOTH(SDSUPPORT, LONG_FILENAME_HOST_SUPPORT)
+      GCODE_M(33, M33),                                           // M33: Get the long full path to a file or folder
+    #endif
 
-      case 75: M75(); break;                                      // M75: Start print timer
-      case 76: M76(); break;                                      // M76: Pause print timer
-      case 77: M77(); break;                                      // M77: Stop print timer
+    #if ENABLED(SDSUPPORT) && BOTH(SDCARD_SORT_ALPHA, SDSORT_GCODE)
+      GCODE_M(34, M34),                                           // M34: Set SD card sorting options
+    #endif
 
-      #if ENABLED(PRINTCOUNTER)
-        case 78: M78(); break;                                    // M78: Show print statistics
-      #endif
+    GCODE_M(42, M42),                                             // M42: Change pin state
 
-      #if ENABLED(M100_FREE_MEMORY_WATCHER)
-        case 100: M100(); break;                                  // M100: Free Memory Report
-      #endif
+    #if ENABLED(PINS_DEBUGGING)
+      GCODE_M(43, M43),                                           // M43: Read pin state
+    #endif
 
-      #if EXTRUDERS
-        case 104: M104(); break;                                  // M104: Set hot end temperature
-        case 109: M109(); break;                                  // M109: Wait for hotend temperature to reach target
-      #endif
+    #if ENABLED(Z_MIN_PROBE_REPEATABILITY_TEST)
+      GCODE_M(48, M48),                                           // M48: Z probe repeatability test
+    #endif
 
-      case 105: M105(); return;                                   // M105: Report Temperatures (and say "ok")
+    #if ENABLED(LCD_SET_PROGRESS_MANUALLY)
+      GCODE_M(73, M73),                                           // M73: Set progress percentage (for display on LCD)
+    #endif
 
-      #if FAN_COUNT > 0
-        case 106: M106(); break;                                  // M106: Fan On
-        case 107: M107(); break;                                  // M107: Fan Off
-      #endif
+    GCODE_M(75, M75),                                             // M75: Start print timer
+    GCODE_M(76, M76),                                             // M76: Pause print timer
+    GCODE_M(77, M77),                                             // M77: Stop print timer
 
-      case 110: M110(); break;                                    // M110: Set Current Line Number
-      case 111: M111(); break;                                    // M111: Set debug level
+    #if ENABLED(PRINTCOUNTER)
+      GCODE_M(78, M78),                                           // M78: Show print statistics
+    #endif
 
-      #if DISABLED(EMERGENCY_PARSER)
-        case 108: M108(); break;                                  // M108: Cancel Waiting
-        case 112: M112(); break;                                  // M112: Full Shutdown
-        case 410: M410(); break;                                  // M410: Quickstop - Abort all the planned moves.
-        #if ENABLED(HOST_PROMPT_SUPPORT)
-          case 876: M876(); break;                                // M876: Handle Host prompt responses
-        #endif
-      #else
-        case 108: case 112: case 410:
-        #if ENABLED(HOST_PROMPT_SUPPORT)
-          case 876:
-        #endif
-        break;
-      #endif
+    #if ENABLED(PSU_CONTROL)
+      GCODE_M(80, M80),                                           // M80: Turn on Power Supply
+    #endif
 
-      #if ENABLED(HOST_KEEPALIVE_FEATURE)
-        case 113: M113(); break;                                  // M113: Set Host Keepalive interval
-      #endif
+    GCODE_M(81, M81),                                             // M81: Turn off Power, including Power Supply, if possible
+    GCODE_M(82, M82),                                             // M82: Set E axis normal mode (same as other axes)
+    GCODE_M(83, M83),                                             // M83: Set E axis relative mode
+    GCODE_M(84, M18_M84),                                         // M84: Disable Steppers / Set Timeout
+    GCODE_M(85, M85),                                             // M85: Set inactivity stepper shutdown timeout
+    GCODE_M(92, M92),                                             // M92: Set the steps-per-unit for one or more axes
 
-      #if HAS_HEATED_BED
-        case 140: M140(); break;                                  // M140: Set bed temperature
-        case 190: M190(); break;                                  // M190: Wait for bed temperature to reach target
-      #endif
+    #if ENABLED(M100_FREE_MEMORY_WATCHER)
+      GCODE_M(100, M100),                                         // M100: Free Memory Report
+    #endif
 
-      #if HAS_HEATED_CHAMBER
-        case 141: M141(); break;                                  // M141: Set chamber temperature
-        case 191: M191(); break;                                  // M191: Wait for chamber temperature to reach target
-      #endif
+    #if EXTRUDERS
+      GCODE_M(104, M104),                                         // M104: Set hot end temperature
+    #endif
 
-      #if ENABLED(AUTO_REPORT_TEMPERATURES) && HAS_TEMP_SENSOR
-        case 155: M155(); break;                                  // M155: Set temperature auto-report interval
-      #endif
+    GCODE_M(105, _M105),                                          // M105: Report Temperatures (and say "ok")
 
-      #if ENABLED(PARK_HEAD_ON_PAUSE)
-        case 125: M125(); break;                                  // M125: Store current position and move to filament change position
-      #endif
+    #if FAN_COUNT > 0
+      GCODE_M(106, M106),                                         // M106: Fan On
+      GCODE_M(107, M107),                                         // M107: Fan Off
+    #endif
 
-      #if ENABLED(BARICUDA)
-        // PWM for HEATER_1_PIN
-        #if HAS_HEATER_1
-          case 126: M126(); break;                                // M126: valve open
-          case 127: M127(); break;                                // M127: valve closed
-        #endif
-
-        // PWM for HEATER_2_PIN
-        #if HAS_HEATER_2
-          case 128: M128(); break;                                // M128: valve open
-          case 129: M129(); break;                                // M129: valve closed
-        #endif
-      #endif // BARICUDA
-
-      #if ENABLED(PSU_CONTROL)
-        case 80: M80(); break;                                    // M80: Turn on Power Supply
-      #endif
-      case 81: M81(); break;                                      // M81: Turn off Power, including Power Supply, if possible
-
-      case 82: M82(); break;                                      // M82: Set E axis normal mode (same as other axes)
-      case 83: M83(); break;                                      // M83: Set E axis relative mode
-      case 18: case 84: M18_M84(); break;                         // M18/M84: Disable Steppers / Set Timeout
-      case 85: M85(); break;                                      // M85: Set inactivity stepper shutdown timeout
-      case 92: M92(); break;                                      // M92: Set the steps-per-unit for one or more axes
-      case 114: M114(); break;                                    // M114: Report current position
-      case 115: M115(); break;                                    // M115: Report capabilities
-      case 117: M117(); break;                                    // M117: Set LCD message text, if possible
-      case 118: M118(); break;                                    // M118: Display a message in the host console
-      case 119: M119(); break;                                    // M119: Report endstop states
-      case 120: M120(); break;                                    // M120: Enable endstops
-      case 121: M121(); break;                                    // M121: Disable endstops
-
-      #if HOTENDS && HAS_LCD_MENU
-        case 145: M145(); break;                                  // M145: Set material heatup parameters
-      #endif
+    #if DISABLED(EMERGENCY_PARSER)
+      GCODE_M(108, M108),                                         // M108: Cancel Waiting
+    #else
+      GCODE_M(108, noop),                                         // Handled by the emergency parser
+    #endif
 
-      #if ENABLED(TEMPERATURE_UNITS_SUPPORT)
-        case 149: M149(); break;                                  // M149: Set temperature units
-      #endif
+    #if EXTRUDERS
+      GCODE_M(109, M109),                                         // M109: Wait for hotend temperature to reach target
+    #endif
 
-      #if HAS_COLOR_LEDS
-        case 150: M150(); break;                                  // M150: Set Status LED Color
-      #endif
+    GCODE_M(110, M110),                                           // M110: Set Current Line Number
+    GCODE_M(111, M111),                                           // M111: Set debug level
 
-      #if ENABLED(MIXING_EXTRUDER)
-        case 163: M163(); break;                                  // M163: Set a component weight for mixing extruder
-        case 164: M164(); break;                                  // M164: Save current mix as a virtual extruder
-        #if ENABLED(DIRECT_MIXING_IN_G1)
-          case 165: M165(); break;                                // M165: Set multiple mix weights
-        #endif
-        #if ENABLED(GRADIENT_MIX)
-          case 166: M166(); break;                                // M166: Set Gradient Mix
-        #endif
-      #endif
+    #if DISABLED(EMERGENCY_PARSER)
+      GCODE_M(112, M112),                                         // M112: Full Shutdown
+    #else
+      GCODE_M(112, noop),                                         // Handled by the emergency parser
+    #endif
 
-      #if DISABLED(NO_VOLUMETRICS)
-        case 200: M200(); break;                                  // M200: Set filament diameter, E to cubic units
-      #endif
+    #if ENABLED(HOST_KEEPALIVE_FEATURE)
+      GCODE_M(113, M113),                                         // M113: Set Host Keepalive interval
+    #endif
 
-      case 201: M201(); break;                                    // M201: Set max acceleration for print moves (units/s^2)
+    GCODE_M(114, M114),                                           // M114: Report current position
+    GCODE_M(115, M115),                                           // M115: Report capabilities
+    GCODE_M(117, M117),                                           // M117: Set LCD message text, if possible
+    GCODE_M(118, M118),                                           // M118: Display a message in the host console
+    GCODE_M(119, M119),                                           // M119: Report endstop states
+    GCODE_M(120, M120),                                           // M120: Enable endstops
+    GCODE_M(121, M121),                                           // M121: Disable endstops
 
-      #if 0
-        case 202: M202(); break;                                  // M202: Not used for Sprinter/grbl gen6
-      #endif
+    #if HAS_TRINAMIC
+      GCODE_M(122, M122),                                         // M122: Report driver configuration and status
+    #endif
 
-      case 203: M203(); break;                                    // M203: Set max feedrate (units/sec)
-      case 204: M204(); break;                                    // M204: Set acceleration
-      case 205: M205(); break;                                    // M205: Set advanced settings
+    #if HAS_DRIVER(L6470)
+      GCODE_M(122, M122),                                         // M122: Report status
+    #endif
 
-      #if HAS_M206_COMMAND
-        case 206: M206(); break;                                  // M206: Set home offsets
-      #endif
+    #if ENABLED(PARK_HEAD_ON_PAUSE)
+      GCODE_M(125, M125),                                         // M125: Store current position and move to filament change position
+    #endif
 
-      #if ENABLED(DELTA)
-        case 665: M665(); break;                                  // M665: Set delta configurations
-      #endif
+    #if ENABLED(BARICUDA) && HAS_HEATER_1
+      GCODE_M(126, M126),                                         // M126: valve open
+      GCODE_M(127, M127),                                         // M127: valve closed
+    #endif
 
-      #if ANY(DELTA, X_DUAL_ENDSTOPS, Y_DUAL_ENDSTOPS, Z_DUAL_ENDSTOPS)
-        case 666: M666(); break;                                  // M666: Set delta or dual endstop adjustment
-      #endif
+    #if ENABLED(BARICUDA) && HAS_HEATER_2
+      GCODE_M(128, M128),                                         // M128: valve open
+      GCODE_M(129, M129),                                         // M129: valve closed
+    #endif
 
-      #if ENABLED(FWRETRACT)
-        case 207: M207(); break;                                  // M207: Set Retract Length, Feedrate, and Z lift
-        case 208: M208(); break;                                  // M208: Set Recover (unretract) Additional Length and Feedrate
-        #if ENABLED(FWRETRACT_AUTORETRACT)
-          case 209:
-            if (MIN_AUTORETRACT <= MAX_AUTORETRACT) M209();       // M209: Turn Automatic Retract Detection on/off
-            break;
-        #endif
-      #endif
+    #if HAS_HEATED_BED
+      GCODE_M(140, M140),                                         // M140: Set bed temperature
+    #endif
 
-      #if HAS_SOFTWARE_ENDSTOPS
-        case 211: M211(); break;                                  // M211: Enable, Disable, and/or Report software endstops
-      #endif
+    #if HAS_HEATED_CHAMBER
+      GCODE_M(141, M141),                                         // M141: Set chamber temperature
+    #endif
 
-      #if EXTRUDERS > 1
-        case 217: M217(); break;                                  // M217: Set filament swap parameters
-      #endif
+    #if HOTENDS && HAS_LCD_MENU
+      GCODE_M(145, M145),                                         // M145: Set material heatup parameters
+    #endif
 
-      #if HAS_HOTEND_OFFSET
-        case 218: M218(); break;                                  // M218: Set a tool offset
-      #endif
+    #if ENABLED(TEMPERATURE_UNITS_SUPPORT)
+      GCODE_M(149, M149),                                         // M149: Set temperature units
+    #endif
 
-      case 220: M220(); break;                                    // M220: Set Feedrate Percentage: S<percent> ("FR" on your LCD)
+    #if HAS_COLOR_LEDS
+      GCODE_M(150, M150),                                         // M150: Set Status LED Color
+    #endif
 
-      #if EXTRUDERS
-        case 221: M221(); break;                                  // M221: Set Flow Percentage
-      #endif
+    #if ENABLED(AUTO_REPORT_TEMPERATURES) && HAS_TEMP_SENSOR
+      GCODE_M(155, M155),                                         // M155: Set temperature auto-report interval
+    #endif
 
-      case 226: M226(); break;                                    // M226: Wait until a pin reaches a state
+    #if ENABLED(MIXING_EXTRUDER)
+      GCODE_M(163, M163),                                         // M163: Set a component weight for mixing extruder
+      GCODE_M(164, M164),                                         // M164: Save current mix as a virtual extruder
+    #endif
 
-      #if HAS_SERVOS
-        case 280: M280(); break;                                  // M280: Set servo position absolute
-        #if ENABLED(EDITABLE_SERVO_ANGLES)
-          case 281: M281(); break;                                // M281: Set servo angles
-        #endif
-      #endif
+    #if BOTH(MIXING_EXTRUDER, DIRECT_MIXING_IN_G1)
+      GCODE_M(165, M165),                                         // M165: Set multiple mix weights
+    #endif
 
-      #if ENABLED(BABYSTEPPING)
-        case 290: M290(); break;                                  // M290: Babystepping
-      #endif
+    #if BOTH(MIXING_EXTRUDER, GRADIENT_MIX)
+      GCODE_M(166, M166),                                         // M166: Set Gradient Mix
+    #endif
 
-      #if HAS_BUZZER
-        case 300: M300(); break;                                  // M300: Play beep tone
-      #endif
+    #if HAS_HEATED_BED
+      GCODE_M(190, M190),                                         // M190: Wait for bed temperature to reach target
+    #endif
 
-      #if ENABLED(PIDTEMP)
-        case 301: M301(); break;                                  // M301: Set hotend PID parameters
-      #endif
+    #if HAS_HEATED_CHAMBER
+      GCODE_M(191, M191),                                         // M191: Wait for chamber temperature to reach target
+    #endif
 
-      #if ENABLED(PIDTEMPBED)
-        case 304: M304(); break;                                  // M304: Set bed PID parameters
-      #endif
+    #if DISABLED(NO_VOLUMETRICS)
+      GCODE_M(200, M200),                                         // M200: Set filament diameter, E to cubic units
+    #endif
 
-      #if ENABLED(PHOTO_GCODE)
-        case 240: M240(); break;                                  // M240: Trigger a camera
-      #endif
+    GCODE_M(201, M201),                                           // M201: Set max acceleration for print moves (units/s^2)
+    GCODE_M(203, M203),                                           // M203: Set max feedrate (units/sec)
+    GCODE_M(204, M204),                                           // M204: Set acceleration
+    GCODE_M(205, M205),                                           // M205: Set advanced settings
 
-      #if HAS_LCD_CONTRAST
-        case 250: M250(); break;                                  // M250: Set LCD contrast
-      #endif
+    #if HAS_M206_COMMAND
+      GCODE_M(206, M206),                                         // M206: Set home offsets
+    #endif
 
-      #if ENABLED(EXPERIMENTAL_I2CBUS)
-        case 260: M260(); break;                                  // M260: Send data to an i2c slave
-        case 261: M261(); break;                                  // M261: Request data from an i2c slave
-      #endif
+    #if ENABLED(FWRETRACT)
+      GCODE_M(207, M207),                                         // M207: Set Retract Length, Feedrate, and Z lift
+      GCODE_M(208, M208),                                         // M208: Set Recover (unretract) Additional Length and Feedrate
+    #endif
 
-      #if ENABLED(PREVENT_COLD_EXTRUSION)
-        case 302: M302(); break;                                  // M302: Allow cold extrudes (set the minimum extrude temperature)
-      #endif
+    #if BOTH(FWRETRACT, FWRETRACT_AUTORETRACT)
+      GCODE_M(209, _M209),                                        // M209: Turn Automatic Retract Detection on/off
+    #endif
 
-      #if HAS_PID_HEATING
-        case 303: M303(); break;                                  // M303: PID autotune
-      #endif
+    #if HAS_SOFTWARE_ENDSTOPS
+      GCODE_M(211, M211),                                         // M211: Enable, Disable, and/or Report software endstops
+    #endif
 
-      #if HAS_USER_THERMISTORS
-        case 305: M305(); break;                                  // M305: Set user thermistor parameters
-      #endif
+    #if EXTRUDERS > 1
+      GCODE_M(217, M217),                                         // M217: Set filament swap parameters
+    #endif
 
-      #if ENABLED(MORGAN_SCARA)
-        case 360: if (M360()) return; break;                      // M360: SCARA Theta pos1
-        case 361: if (M361()) return; break;                      // M361: SCARA Theta pos2
-        case 362: if (M362()) return; break;                      // M362: SCARA Psi pos1
-        case 363: if (M363()) return; break;                      // M363: SCARA Psi pos2
-        case 364: if (M364()) return; break;                      // M364: SCARA Psi pos3 (90 deg to Theta)
-      #endif
+    #if HAS_HOTEND_OFFSET
+      GCODE_M(218, M218),                                         // M218: Set a tool offset
+    #endif
 
-      #if EITHER(EXT_SOLENOID, MANUAL_SOLENOID_CONTROL)
-        case 380: M380(); break;                                  // M380: Activate solenoid on active (or specified) extruder
-        case 381: M381(); break;                                  // M381: Disable all solenoids or, if MANUAL_SOLENOID_CONTROL, active (or specified) solenoid
-      #endif
+    GCODE_M(220, M220),                                           // M220: Set Feedrate Percentage: S<percent> ("FR" on your LCD)
 
-      case 400: M400(); break;                                    // M400: Finish all moves
+    #if EXTRUDERS
+      GCODE_M(221, M221),                                         // M221: Set Flow Percentage
+    #endif
 
-      #if HAS_BED_PROBE
-        case 401: M401(); break;                                  // M401: Deploy probe
-        case 402: M402(); break;                                  // M402: Stow probe
-      #endif
+    GCODE_M(226, M226),                                           // M226: Wait until a pin reaches a state
 
-      #if ENABLED(PRUSA_MMU2)
-        case 403: M403(); break;
-      #endif
+    #if ENABLED(PHOTO_GCODE)
+      GCODE_M(240, M240),                                         // M240: Trigger a camera
+    #endif
 
-      #if ENABLED(FILAMENT_WIDTH_SENSOR)
-        case 404: M404(); break;                                  // M404: Enter the nominal filament width (3mm, 1.75mm ) N<3.0> or display nominal filament width
-        case 405: M405(); break;                                  // M405: Turn on filament sensor for control
-        case 406: M406(); break;                                  // M406: Turn off filament sensor for control
-        case 407: M407(); break;                                  // M407: Display measured filament diameter
-      #endif
+    #if HAS_LCD_CONTRAST
+      GCODE_M(250, M250),                                         // M250: Set LCD contrast
+    #endif
 
-      #if HAS_FILAMENT_SENSOR
-        case 412: M412(); break;                                  // M412: Enable/Disable filament runout detection
-      #endif
+    #if ENABLED(EXPERIMENTAL_I2CBUS)
+      GCODE_M(260, M260),                                         // M260: Send data to an i2c slave
+      GCODE_M(261, M261),                                         // M261: Request data from an i2c slave
+    #endif
 
-      #if HAS_LEVELING
-        case 420: M420(); break;                                  // M420: Enable/Disable Bed Leveling
-      #endif
+    #if HAS_SERVOS
+      GCODE_M(280, M280),                                         // M280: Set servo position absolute
+    #endif
 
-      #if HAS_MESH
-        case 421: M421(); break;                                  // M421: Set a Mesh Bed Leveling Z coordinate
-      #endif
+    #if HAS_SERVOS && ENABLED(EDITABLE_SERVO_ANGLES)
+      GCODE_M(281, M281),                                         // M281: Set servo angles
+    #endif
 
-      #if ENABLED(BACKLASH_GCODE)
-        case 425: M425(); break;                                  // M425: Tune backlash compensation
-      #endif
+    #if ENABLED(BABYSTEPPING)
+      GCODE_M(290, M290),                                         // M290: Babystepping
+    #endif
 
-      #if HAS_M206_COMMAND
-        case 428: M428(); break;                                  // M428: Apply current_position to home_offset
-      #endif
+    #if HAS_BUZZER
+      GCODE_M(300, M300),                                         // M300: Play beep tone
+    #endif
 
-      #if ENABLED(CANCEL_OBJECTS)
-        case 486: M486(); break;                                  // M486: Identify and cancel objects
-      #endif
+    #if ENABLED(PIDTEMP)
+      GCODE_M(301, M301),                                         // M301: Set hotend PID parameters
+    #endif
 
-      case 500: M500(); break;                                    // M500: Store settings in EEPROM
-      case 501: M501(); break;                                    // M501: Read settings from EEPROM
-      case 502: M502(); break;                                    // M502: Revert to default settings
-      #if DISABLED(DISABLE_M503)
-        case 503: M503(); break;                                  // M503: print settings currently in memory
-      #endif
-      #if ENABLED(EEPROM_SETTINGS)
-        case 504: M504(); break;                                  // M504: Validate EEPROM contents
-      #endif
+    #if ENABLED(PREVENT_COLD_EXTRUSION)
+      GCODE_M(302, M302),                                         // M302: Allow cold extrudes (set the minimum extrude temperature)
+    #endif
 
-      #if ENABLED(SDSUPPORT)
-        case 524: M524(); break;                                   // M524: Abort the current SD print job
-      #endif
+    #if HAS_PID_HEATING
+      GCODE_M(303, M303),                                         // M303: PID autotune
+    #endif
 
-      #if ENABLED(SD_ABORT_ON_ENDSTOP_HIT)
-        case 540: M540(); break;                                  // M540: Set abort on endstop hit for SD printing
-      #endif
+    #if ENABLED(PIDTEMPBED)
+      GCODE_M(304, M304),                                         // M304: Set bed PID parameters
+    #endif
 
-      #if ENABLED(BAUD_RATE_GCODE)
-        case 575: M575(); break;                                  // M575: Set serial baudrate
-      #endif
+    #if HAS_USER_THERMISTORS
+      GCODE_M(305, M305),                                         // M305: Set user thermistor parameters
+    #endif
 
-      #if HAS_BED_PROBE
-        case 851: M851(); break;                                  // M851: Set Z Probe Z Offset
-      #endif
+    #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+      GCODE_M(318, M318),                                         // M318: Report / tune stepper ISR multi-stepping limits
+    #endif
 
-      #if ENABLED(SKEW_CORRECTION_GCODE)
-        case 852: M852(); break;                                  // M852: Set Skew factors
-      #endif
-      
-      #if ENABLED(WIFISUPPORT)
-         case 585: GcodeSuite::M585(); break;                                // M585: Set hostname
-         case 586: GcodeSuite::M586(); break;                                // M586: Configure Network protocols
-         case 587: GcodeSuite::M587(); break;                                // M587: Set WiFi STA host network
-         case 588: GcodeSuite::M588(); break;                                // M588: Set WiFi mode
-         case 589: GcodeSuite::M589(); break;                                // M589: Configure access point parameters
-      #endif
-      
-      #if ENABLED(ADVANCED_PAUSE_FEATURE)
-        case 600: M600(); break;                                  // M600: Pause for Filament Change
-        case 603: M603(); break;                                  // M603: Configure Filament Change
-      #endif
+    #if HAS_MICROSTEPS
+      GCODE_M(350, M350),                                         // M350: Set microstepping mode. Warning: Steps per unit remains unchanged. S code sets stepping mode for all drivers.
+      GCODE_M(351, M351),                                         // M351: Toggle MS1 MS2 pins directly, S# determines MS1 or MS2, X# sets the pin high/low.
+    #endif
 
-      #if HAS_DUPLICATION_MODE
-        case 605: M605(); break;                                  // M605: Set Dual X Carriage movement mode
-      #endif
+    #if HAS_CASE_LIGHT
+      GCODE_M(355, M355),                                         // M355: Set case light brightness
+    #endif
 
-      #if ENABLED(FILAMENT_LOAD_UNLOAD_GCODES)
-        case 701: M701(); break;                                  // M701: Load Filament
-        case 702: M702(); break;                                  // M702: Unload Filament
-      #endif
+    #if ENABLED(MORGAN_SCARA)
+      GCODE_M(360, _M360),                                        // M360: SCARA Theta pos1
+      GCODE_M(361, _M361),                                        // M361: SCARA Theta pos2
+      GCODE_M(362, _M362),                                        // M362: SCARA Psi pos1
+      GCODE_M(363, _M363),                                        // M363: SCARA Psi pos2
+      GCODE_M(364, _M364),                                        // M364: SCARA Psi pos3 (90 deg to Theta)
+    #endif
 
-      #if ENABLED(MAX7219_GCODE)
-        case 7219: M7219(); break;                                // M7219: Set LEDs, columns, and rows
-      #endif
+    #if EITHER(EXT_SOLENOID, MANUAL_SOLENOID_CONTROL)
+      GCODE_M(380, M380),                                         // M380: Activate solenoid on active (or specified) extruder
+      GCODE_M(381, M381),                                         // M381: Disable all solenoids or, if MANUAL_SOLENOID_CONTROL, active (or specified) solenoid
+    #endif
 
-      #if ENABLED(GCODE_MACROS)
-        case 810: case 811: case 812: case 813: case 814:
-        case 815: case 816: case 817: case 818: case 819:
-        M810_819(); break;                                        // M810-M819: Define/execute G-code macro
-      #endif
+    GCODE_M(400, M400),                                           // M400: Finish all moves
 
-      #if ENABLED(LIN_ADVANCE)
-        case 900: M900(); break;                                  // M900: Set advance K factor.
-      #endif
+    #if HAS_BED_PROBE
+      GCODE_M(401, M401),                                         // M401: Deploy probe
+      GCODE_M(402, M402),                                         // M402: Stow probe
+    #endif
 
-      #if HAS_DIGIPOTSS || HAS_MOTOR_CURRENT_PWM || EITHER(DIGIPOT_I2C, DAC_STEPPER_CURRENT)
-        case 907: M907(); break;                                  // M907: Set digital trimpot motor current using axis codes.
-        #if HAS_DIGIPOTSS || ENABLED(DAC_STEPPER_CURRENT)
-          case 908: M908(); break;                                // M908: Control digital trimpot directly.
-          #if ENABLED(DAC_STEPPER_CURRENT)
-            case 909: M909(); break;                              // M909: Print digipot/DAC current value
-            case 910: M910(); break;                              // M910: Commit digipot/DAC value to external EEPROM
-          #endif
-        #endif
-      #endif
+    #if ENABLED(PRUSA_MMU2)
+      GCODE_M(403, M403),
+    #endif
 
-      #if HAS_TRINAMIC
-        case 122: M122(); break;                                  // M122: Report driver configuration and status
-        case 906: M906(); break;                                  // M906: Set motor current in milliamps using axis codes X, Y, Z, E
-        #if HAS_STEALTHCHOP
-          case 569: M569(); break;                                // M569: Enable stealthChop on an axis.
-        #endif
-        #if ENABLED(MONITOR_DRIVER_STATUS)
-          case 911: M911(); break;                                // M911: Report TMC2130 prewarn triggered flags
-          case 912: M912(); break;                                // M912: Clear TMC2130 prewarn triggered flags
-        #endif
-        #if ENABLED(HYBRID_THRESHOLD)
-          case 913: M913(); break;                                // M913: Set HYBRID_THRESHOLD speed.
-        #endif
-        #if USE_SENSORLESS
-          case 914: M914(); break;                                // M914: Set StallGuard sensitivity.
-        #endif
-      #endif
+    #if ENABLED(FILAMENT_WIDTH_SENSOR)
+      GCODE_M(404, M404),                                         // M404: Enter the nominal filament width (3mm, 1.75mm ) N<3.0> or display nominal filament width
+      GCODE_M(405, M405),                                         // M405: Turn on filament sensor for control
+      GCODE_M(406, M406),                                         // M406: Turn off filament sensor for control
+      GCODE_M(407, M407),                                         // M407: Display measured filament diameter
+    #endif
 
-      #if HAS_DRIVER(L6470)
-        case 122: M122(); break;                                   // M122: Report status
-        case 906: M906(); break;                                   // M906: Set or get motor drive level
-        case 916: M916(); break;                                   // M916: L6470 tuning: Increase drive level until thermal warning
-        case 917: M917(); break;                                   // M917: L6470 tuning: Find minimum current thresholds
-        case 918: M918(); break;                                   // M918: L6470 tuning: Increase speed until max or error
-      #endif
+    #if DISABLED(EMERGENCY_PARSER)
+      GCODE_M(410, M410),                                         // M410: Quickstop - Abort all the planned moves.
+    #else
+      GCODE_M(410, noop),                                         // Handled by the emergency parser
+    #endif
 
-      #if HAS_MICROSTEPS
-        case 350: M350(); break;                                  // M350: Set microstepping mode. Warning: Steps per unit remains unchanged. S code sets stepping mode for all drivers.
-        case 351: M351(); break;                                  // M351: Toggle MS1 MS2 pins directly, S# determines MS1 or MS2, X# sets the pin high/low.
-      #endif
+    #if HAS_FILAMENT_SENSOR
+      GCODE_M(412, M412),                                         // M412: Enable/Disable filament runout detection
+    #endif
 
-      #if HAS_CASE_LIGHT
-        case 355: M355(); break;                                  // M355: Set case light brightness
-      #endif
+    #if ENABLED(POWER_LOSS_RECOVERY)
+      GCODE_M(413, M413),                                         // M413: Enable/disable/query Power-Loss Recovery
+    #endif
 
-      #if ENABLED(DEBUG_GCODE_PARSER)
-        case 800: parser.debug(); break;                          // M800: GCode Parser Test for M
-      #endif
+    #if HAS_LEVELING
+      GCODE_M(420, M420),                                         // M420: Enable/Disable Bed Leveling
+    #endif
 
-      #if ENABLED(I2C_POSITION_ENCODERS)
-        case 860: M860(); break;                                  // M860: Report encoder module position
-        case 861: M861(); break;                                  // M861: Report encoder module status
-        case 862: M862(); break;                                  // M862: Perform axis test
-        case 863: M863(); break;                                  // M863: Calibrate steps/mm
-        case 864: M864(); break;                                  // M864: Change module address
-        case 865: M865(); break;                                  // M865: Check module firmware version
-        case 866: M866(); break;                                  // M866: Report axis error count
-        case 867: M867(); break;                                  // M867: Toggle error correction
-        case 868: M868(); break;                                  // M868: Set error correction threshold
-        case 869: M869(); break;                                  // M869: Report axis error
-      #endif
+    #if HAS_MESH
+      GCODE_M(421, M421),                                         // M421: Set a Mesh Bed Leveling Z coordinate
+    #endif
 
-      #if ENABLED(MAGNETIC_PARKING_EXTRUDER)
-        case 951: M951(); break;                                  // M951: Set Magnetic Parking Extruder parameters
-      #endif
+    #if ENABLED(Z_STEPPER_AUTO_ALIGN)
+      GCODE_M(422, M422),                                         // M422: Set Z Stepper automatic alignment position using probe
+    #endif
 
-      #if ENABLED(Z_STEPPER_AUTO_ALIGN)
-        case 422: M422(); break;                                  // M422: Set Z Stepper automatic alignment position using probe
-      #endif
+    #if ENABLED(BACKLASH_GCODE)
+      GCODE_M(425, M425),                                         // M425: Tune backlash compensation
+    #endif
 
-      #if ENABLED(PLATFORM_M997_SUPPORT)
-        case 997: M997(); break;                                  // M997: Perform in-application firmware update
-      #endif
+    #if HAS_M206_COMMAND
+      GCODE_M(428, M428),                                         // M428: Apply current_position to home_offset
+    #endif
 
-      case 999: M999(); break;                                    // M999: Restart after being Stopped
+    #if ENABLED(CANCEL_OBJECTS)
+      GCODE_M(486, M486),                                         // M486: Identify and cancel objects
+    #endif
+
+    GCODE_M(500, M500),                                           // M500: Store settings in EEPROM
+    GCODE_M(501, M501),                                           // M501: Read settings from EEPROM
+    GCODE_M(502, M502),                                           // M502: Revert to default settings
+
+    #if DISABLED(DISABLE_M503)
+      GCODE_M(503, M503),                                         // M503: print settings currently in memory
+    #endif
+
+    #if ENABLED(EEPROM_SETTINGS)
+      GCODE_M(504, M504),                                         // M504: Validate EEPROM contents
+    #endif
 
-      #if ENABLED(POWER_LOSS_RECOVERY)
-        case 413: M413(); break;                                  // M413: Enable/disable/query Power-Loss Recovery
-        case 1000: M1000(); break;                                // M1000: Resume from power-loss
+    #if ENABLED(SDSUPPORT)
+      GCODE_M(524, M524),                                         // M524: Abort the current SD print job
+    #endif
+
+    #if ENABLED(SD_ABORT_ON_ENDSTOP_HIT)
+      GCODE_M(540, M540),                                         // M540: Set abort on endstop hit for SD printing
+    #endif
+
+    #if HAS_TRINAMIC && HAS_STEALTHCHOP
+      GCODE_M(569, M569),                                         // M569: Enable stealthChop on an axis.
+    #endif
+
+    #if ENABLED(BAUD_RATE_GCODE)
+      GCODE_M(575, M575),                                         // M575: Set serial baudrate
+    #endif
+
+    #if ENABLED(SERIAL_CREDIT_FLOW)
+      GCODE_M(577, M577),                                         // M577: Credit-based flow control
+    #endif
+
+    #if ENABLED(SERIAL_PORT_SCHEDULER)
+      GCODE_M(578, M578),                                         // M578: Serial port scheduler
+    #endif
+
+    #if ENABLED(WIFISUPPORT)
+      GCODE_M(585, M585),                                         // M585: Set hostname
+      GCODE_M(586, M586),                                         // M586: Configure Network protocols
+      GCODE_M(587, M587),                                         // M587: Set WiFi STA host network
+      GCODE_M(588, M588),                                         // M588: Set WiFi mode
+      GCODE_M(589, M589),                                         // M589: Configure access point parameters
+    #endif
+
+    #if ENABLED(INPUT_SHAPING)
+      GCODE_M(593, M593),                                         // M593: Set input shaping
+    #endif
+
+    #if ENABLED(ADVANCED_PAUSE_FEATURE)
+      GCODE_M(600, M600),                                         // M600: Pause for Filament Change
+      GCODE_M(603, M603),                                         // M603: Configure Filament Change
+    #endif
+
+    #if HAS_DUPLICATION_MODE
+      GCODE_M(605, M605),                                         // M605: Set Dual X Carriage movement mode
+    #endif
+
+    #if ENABLED(DELTA)
+      GCODE_M(665, M665),                                         // M665: Set delta configurations
+    #endif
+
+    #if ANY(DELTA, X_DUAL_ENDSTOPS, Y_DUAL_ENDSTOPS, Z_DUAL_ENDSTOPS)
+      GCODE_M(666, M666),                                         // M666: Set delta or dual endstop adjustment
+    #endif
+
+    #if ENABLED(FILAMENT_LOAD_UNLOAD_GCODES)
+      GCODE_M(701, M701),                                         // M701: Load Filament
+      GCODE_M(702, M702),                                         // M702: Unload Filament
+    #endif
+
+    #if ENABLED(DEBUG_GCODE_PARSER)
+      GCODE_M(800, GCodeParser::debug),                           // M800: GCode Parser Test for M
+    #endif
+
+    #if ENABLED(GCODE_MACROS)
+      GCODE_M(810, M810_819),                                     // M810: Define/execute G-code macro
+      GCODE_M(811, M810_819),                                     // M811: Define/execute G-code macro
+      GCODE_M(812, M810_819),                                     // M812: Define/execute G-code macro
+      GCODE_M(813, M810_819),                                     // M813: Define/execute G-code macro
+      GCODE_M(814, M810_819),                                     // M814: Define/execute G-code macro
+      GCODE_M(815, M810_819),                                     // M815: Define/execute G-code macro
+      GCODE_M(816, M810_819),                                     // M816: Define/execute G-code macro
+      GCODE_M(817, M810_819),                                     // M817: Define/execute G-code macro
+      GCODE_M(818, M810_819),                                     // M818: Define/execute G-code macro
+      GCODE_M(819, M810_819),                                     // M819: Define/execute G-code macro
+    #endif
+
+    #if HAS_BED_PROBE
+      GCODE_M(851, M851),                                         // M851: Set Z Probe Z Offset
+    #endif
+
+    #if ENABLED(SKEW_CORRECTION_GCODE)
+      GCODE_M(852, M852),                                         // M852: Set Skew factors
+    #endif
+
+    #if ENABLED(I2C_POSITION_ENCODERS)
+      GCODE_M(860, M860),                                         // M860: Report encoder module position
+      GCODE_M(861, M861),                                         // M861: Report encoder module status
+      GCODE_M(862, M862),                                         // M862: Perform axis test
+      GCODE_M(863, M863),                                         // M863: Calibrate steps/mm
+      GCODE_M(864, M864),                                         // M864: Change module address
+      GCODE_M(865, M865),                                         // M865: Check module firmware version
+      GCODE_M(866, M866),                                         // M866: Report axis error count
+      GCODE_M(867, M867),                                         // M867: Toggle error correction
+      GCODE_M(868, M868),                                         // M868: Set error correction threshold
+      GCODE_M(869, M869),                                         // M869: Report axis error
+    #endif
+
+    #if ENABLED(HOST_PROMPT_SUPPORT)
+      #if DISABLED(EMERGENCY_PARSER)
+        GCODE_M(876, M876),                                       // M876: Handle Host prompt responses
+      #else
+        GCODE_M(876, noop),                                       // Handled by the emergency parser
       #endif
+    #endif
 
-      default: parser.unknown_command_error(); break;
-    }
-    break;
+    #if ENABLED(LIN_ADVANCE)
+      GCODE_M(900, M900),                                         // M900: Set advance K factor.
+    #endif
+
+    #if HAS_TRINAMIC
+      GCODE_M(906, M906),                                         // M906: Set motor current in milliamps using axis codes X, Y, Z, E
+    #endif
+
+    #if HAS_DRIVER(L6470)
+      GCODE_M(906, M906),                                         // M906: Set or get motor drive level
+    #endif
+
+    #if HAS_DIGIPOTSS || HAS_MOTOR_CURRENT_PWM || EITHER(DIGIPOT_I2C, DAC_STEPPER_CURRENT)
+      GCODE_M(907, M907),                                         // M907: Set digital trimpot motor current using axis codes.
+    #endif
+
+    #if (HAS_DIGIPOTSS || HAS_MOTOR_CURRENT_PWM || EITHER(DIGIPOT_I2C, DAC_STEPPER_CURRENT)) && (HAS_DIGIPOTSS || ENABLED(DAC_STEPPER_CURRENT))
+      GCODE_M(908, M908),                                         // M908: Control digital trimpot directly.
+    #endif
+
+    #if (HAS_DIGIPOTSS || HAS_MOTOR_CURRENT_PWM || EITHER(DIGIPOT_I2C, DAC_STEPPER_CURRENT)) && (HAS_DIGIPOTSS || ENABLED(DAC_STEPPER_CURRENT)) && ENABLED(DAC_STEPPER_CURRENT)
+      GCODE_M(909, M909),                                         // M909: Print digipot/DAC current value
+      GCODE_M(910, M910),                                         // M910: Commit digipot/DAC value to external EEPROM
+    #endif
+
+    #if HAS_TRINAMIC && ENABLED(MONITOR_DRIVER_STATUS)
+      GCODE_M(911, M911),                                         // M911: Report TMC2130 prewarn triggered flags
+      GCODE_M(912, M912),                                         // M912: Clear TMC2130 prewarn triggered flags
+    #endif
+
+    #if HAS_TRINAMIC && ENABLED(HYBRID_THRESHOLD)
+      GCODE_M(913, M913),                                         // M913: Set HYBRID_THRESHOLD speed.
+    #endif
+
+    #if HAS_TRINAMIC && USE_SENSORLESS
+      GCODE_M(914, M914),                                         // M914: Set StallGuard sensitivity.
+    #endif
+
+    #if HAS_DRIVER(L6470)
+      GCODE_M(916, M916),                                         // M916: L6470 tuning: Increase drive level until thermal warning
+      GCODE_M(917, M917),                                         // M917: L6470 tuning: Find minimum current thresholds
+      GCODE_M(918, M918),                                         // M918: L6470 tuning: Increase speed until max or error
+    #endif
+
+    #if ENABLED(SDSUPPORT)
+      GCODE_M(928, M928),                                         // M928: Start SD write
+    #endif
+
+    #if ENABLED(MAGNETIC_PARKING_EXTRUDER)
+      GCODE_M(951, M951),                                         // M951: Set Magnetic Parking Extruder parameters
+    #endif
+
+    #if ENABLED(PLATFORM_M997_SUPPORT)
+      GCODE_M(997, M997),                                         // M997: Perform in-application firmware update
+    #endif
+
+    GCODE_M(999, M999),                                           // M999: Restart after being Stopped
+
+    #if ENABLED(POWER_LOSS_RECOVERY)
+      GCODE_M(1000, M1000),                                       // M1000: Resume from power-loss
+    #endif
+
+    #if ENABLED(MAX7219_GCODE)
+      GCODE_M(7219, M7219),                                       // M7219: Set LEDs, columns, and rows
+    #endif
+  };
+  static_assert(keys_ascending(table, COUNT(table)), "G-code dispatch table entries must be in ascending order.");
+
+  uint16_t key;
+  switch (letter) {
+    case 'G': key = codenum; break;
+    case 'M': key = DISPATCH_M | codenum; break;
+    default: return nullptr;
+  }
+  if (codenum >= DISPATCH_M) return nullptr;
+
+  uint16_t lo = 0, hi = COUNT(table);
+  while (lo < hi) {
+    const uint16_t mid = (lo + hi) >> 1, k = pgm_read_word(&table[mid].key);
+    if (k == key) return (handler_t)pgm_read_ptr(&table[mid].handler);
+    if (k < key) lo = mid + 1; else hi = mid;
+  }
+  return nullptr;
+}
+
+/**
+ * Process the parsed command and dispatch it to its handler
+ */
+void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
+  KEEPALIVE_STATE(IN_HANDLER);
 
-    case 'T': T(parser.codenum); break;                           // Tn: Tool Change
+  #if ENABLED(SEGMENT_COALESCING)
+    // Only G0-G3 moves may be merged. Other commands take effect after the held-back move.
+    if (parser.command_letter != 'G' || parser.codenum > 3) planner.flush_coalesced();
+  #endif
+
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    const MotionBenchmark::command_mark_t profile_mark = benchmark.command_start(parser.command_letter, parser.codenum);
+  #endif
 
-    default: parser.unknown_command_error();
+  // Handle a known G, M, or T
+  if (parser.command_letter == 'T')
+    T(parser.codenum);                                            // Tn: Tool Change
+  else {
+    #if ENABLED(MOTION_BENCHMARK)
+      // One lookup is shorter than a clock tick, so time a batch of them
+      volatile char letter = parser.command_letter;
+      volatile uint16_t codenum = parser.codenum;
+      volatile handler_t found;
+      const uint64_t started = benchmark.now();
+      for (uint8_t i = benchmark.dispatch_batch; i--;) found = find_handler(letter, codenum);
+      benchmark.dispatch_done(benchmark.now() - started);
+      UNUSED(found);
+    #endif
+    const handler_t handler = find_handler(parser.command_letter, parser.codenum);
+    if (handler) handler(); else parser.unknown_command_error();
   }
 
-  if (!no_ok) queue.ok_to_send();
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.command_end(profile_mark);
+  #endif
+
+  if (skip_ok)
+    skip_ok = false;
+  else if (!no_ok)
+    queue.ok_to_send();
 }
 
 /**
@@ -860,7 +1033,12 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
  * This is called from the main loop()
  */
 void GcodeSuite::process_next_command() {
-  char * const current_command = queue.command_buffer[queue.index_r];
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    const parsed_command_t &queued = queue.command_buffer[queue.index_r];
+    char * const current_command = queued.text == NO_COMMAND_TEXT ? nullptr : queue.text_buffer[queued.text];
+  #else
+    char * const current_command = queue.command_buffer[queue.index_r];
+  #endif
 
   PORT_REDIRECT(queue.port[queue.index_r]);
 
@@ -868,17 +1046,28 @@ void GcodeSuite::process_next_command() {
     recovery.queue_index_r = queue.index_r;
   #endif
 
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    if (!current_command) parser.load(queued);
+  #endif
+
   if (DEBUGGING(ECHO)) {
     SERIAL_ECHO_START();
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      if (!current_command) { parser.echo_command(); SERIAL_EOL(); } else
+    #endif
     SERIAL_ECHOLN(current_command);
     #if ENABLED(M100_FREE_MEMORY_DUMPER)
       SERIAL_ECHOPAIR("slot:", queue.index_r);
-      M100_dump_routine(PSTR("   Command Queue:"), queue.command_buffer, queue.command_buffer + sizeof(queue.command_buffer));
+      M100_dump_routine(PSTR("   Command Queue:"), (char*)queue.command_buffer, (char*)queue.command_buffer + sizeof(queue.command_buffer));
     #endif
   }
 
   // Parse the next command in the queue
-  parser.parse(current_command);
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    if (current_command) parser.parse(current_command);
+  #else
+    parser.parse(current_command);
+  #endif
   process_parsed_command();
 }
 
@@ -889,6 +1078,9 @@ void GcodeSuite::process_next_command() {
 
 void GcodeSuite::process_subcommands_now_P(PGM_P pgcode) {
   char * const saved_cmd = parser.command_ptr;        // Save the parser state
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    const parsed_command_t * const saved_record = parser.record;
+  #endif
   for (;;) {
     PGM_P const delim = strchr_P(pgcode, '\n');       // Get address of next newline
     const size_t len = delim ? delim - pgcode : strlen_P(pgcode); // Get the command length
@@ -900,11 +1092,17 @@ void GcodeSuite::process_subcommands_now_P(PGM_P pgcode) {
     if (!delim) break;                                // Last command?
     pgcode = delim + 1;                               // Get the next command
   }
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    if (saved_record) parser.load(*saved_record); else
+  #endif
   parser.parse(saved_cmd);                            // Restore the parser state
 }
 
 void GcodeSuite::process_subcommands_now(char * gcode) {
   char * const saved_cmd = parser.command_ptr;        // Save the parser state
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    const parsed_command_t * const saved_record = parser.record;
+  #endif
   for (;;) {
     char * const delim = strchr(gcode, '\n');         // Get address of next newline
     if (delim) *delim = '\0';                         // Replace with nul
@@ -913,6 +1111,9 @@ void GcodeSuite::process_subcommands_now(char * gcode) {
     if (!delim) break;                                // Last command?
     gcode = delim + 1;                                // Get the next command
   }
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    if (saved_record) parser.load(*saved_record); else
+  #endif
   parser.parse(saved_cmd);                            // Restore the parser state
 }
 
@@ -97,6 +97,7 @@
  *        OR, with 'S<seconds>' set the SD status auto-report interval. (Requires AUTO_REPORT_SD_STATUS)
  *        OR, with 'C' get the current filename.
  * M28  - Start SD write: "M28 /path/file.gco". (Requires SDSUPPORT)
+ *        "M28 B1" switches to binary streaming. (Requires BINARY_FILE_TRANSFER or BINARY_GCODE_STREAMING)
  * M29  - Stop SD write. (Requires SDSUPPORT)
  * M30  - Delete file from SD: "M30 /path/file.gco"
  * M31  - Report time since last M109 or SD card start to serial.
@@ -193,6 +194,7 @@
  * M303 - PID relay autotune S<temperature> sets the target temperature. Default 150C. (Requires PIDTEMP)
  * M304 - Set bed PID parameters P I and D. (Requires PIDTEMPBED)
  * M305 - Set user thermistor parameters R T and P. (Requires TEMP_SENSOR_x 1000)
+ * M318 - Report stepper ISR timing and multi-stepping limits. "R" resets, "S<percent>" sets the ISR load. (Requires ADAPTIVE_MULTI_STEPPING)
  * M350 - Set microstepping mode. (Requires digital microstepping pins.)
  * M351 - Toggle MS1 MS2 pins directly. (Requires digital microstepping pins.)
  * M355 - Set Case Light on/off and set brightness. (Requires CASE_LIGHT_PIN)
@@ -223,6 +225,9 @@
  * M524 - Abort the current SD print job started with M24. (Requires SDSUPPORT)
  * M540 - Enable/disable SD card abort on endstop hit: "M540 S<state>". (Requires SD_ABORT_ON_ENDSTOP_HIT)
  * M569 - Enable stealthChop on an axis. (Requires at least one _DRIVER_TYPE to be TMC2130/2160/2208/2209/5130/5160)
+ * M577 - Credit-based flow control: "M577 S<bool> B<batch>". (Requires SERIAL_CREDIT_FLOW)
+ * M578 - Serial port scheduler: "M578 W<weight> R". (Requires SERIAL_PORT_SCHEDULER)
+ * M593 - Get or set input shaping: "M593 [X] [Y] F<hz> D<damping> T<type>". (Requires INPUT_SHAPING)
  * M600 - Pause for filament change: "M600 X<pos> Y<pos> Z<raise> E<first_retract> L<later_retract>". (Requires ADVANCED_PAUSE_FEATURE)
  * M603 - Configure filament change: "M603 T<tool> U<unload_length> L<load_length>". (Requires ADVANCED_PAUSE_FEATURE)
  * M605 - Set Dual X-Carriage movement mode: "M605 S<mode> [X<x_offset>] [R<temp_offset>]". (Requires DUAL_X_CARRIAGE)
@@ -373,6 +378,40 @@ public:
 
 private:
 
+  // Command dispatch. M code keys have the top bit set.
+  typedef void (*handler_t)();
+  struct dispatch_t { uint16_t key; handler_t handler; };
+  static constexpr uint16_t DISPATCH_M = 0x8000;
+  static handler_t find_handler(const char letter, const uint16_t codenum);
+
+  // Handlers for the dispatch table that call others with arguments
+  static void noop();
+  static void _G0_G1();
+  #if ENABLED(ARC_SUPPORT) && DISABLED(SCARA)
+    static void _G2_G3();
+  #endif
+  static void _G28();
+  #if ENABLED(G38_PROBE_TARGET)
+    static void _G38();
+  #endif
+  static void _G90();
+  static void _G91();
+  #if HAS_CUTTER
+    static void _M3();
+    static void _M4();
+  #endif
+  static void _M105();
+  #if BOTH(FWRETRACT, FWRETRACT_AUTORETRACT)
+    static void _M209();
+  #endif
+  #if ENABLED(MORGAN_SCARA)
+    static void _M360();
+    static void _M361();
+    static void _M362();
+    static void _M363();
+    static void _M364();
+  #endif
+
   static void G0_G1(
     #if IS_SCARA || defined(G0_FEEDRATE)
       const bool fast_move=false
@@ -514,11 +553,14 @@ private:
     static void M25();
     static void M26();
     static void M27();
-    static void M28();
     static void M29();
     static void M30();
   #endif
 
+  #if EITHER(SDSUPPORT, BINARY_GCODE_STREAMING)
+    static void M28();
+  #endif
+
   static void M31();
 
   #if ENABLED(SDSUPPORT)
@@ -744,6 +786,10 @@ private:
     static void M305();
   #endif
 
+  #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+    static void M318();
+  #endif
+
   #if HAS_MICROSTEPS
     static void M350();
     static void M351();
@@ -827,6 +873,14 @@ private:
     static void M575();
   #endif
 
+  #if ENABLED(SERIAL_CREDIT_FLOW)
+    static void M577();
+  #endif
+
+  #if ENABLED(SERIAL_PORT_SCHEDULER)
+    static void M578();
+  #endif
+
   
   #if ENABLED(WIFISUPPORT)
     static void M585();
@@ -836,6 +890,10 @@ private:
     static void M589();
   #endif
   
+  #if ENABLED(INPUT_SHAPING)
+    static void M593();
+  #endif
+
   #if ENABLED(ADVANCED_PAUSE_FEATURE)
     static void M600();
     static void M603();
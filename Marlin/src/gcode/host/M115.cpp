@@ -55,6 +55,27 @@ void GcodeSuite::M115() {
       #endif
     );
 
+    // SERIAL_CREDIT_FLOW (M577)
+    cap_line(PSTR("CREDIT_FLOW")
+      #if ENABLED(SERIAL_CREDIT_FLOW)
+        , true
+      #endif
+    );
+
+    // SERIAL_SELECTIVE_RESEND
+    cap_line(PSTR("SELECTIVE_RESEND")
+      #if ENABLED(SERIAL_SELECTIVE_RESEND)
+        , true
+      #endif
+    );
+
+    // BINARY_GCODE_STREAMING (M28 B1)
+    cap_line(PSTR("BINARY_GCODE_STREAM")
+      #if ENABLED(BINARY_GCODE_STREAMING)
+        , true
+      #endif
+    );
+
     // EEPROM (M500, M501)
     cap_line(PSTR("EEPROM")
       #if ENABLED(EEPROM_SETTINGS)
@@ -0,0 +1,64 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2019 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(SERIAL_CREDIT_FLOW)
+
+#include "../gcode.h"
+#include "../queue.h"
+
+/**
+ * M577: Credit-based flow control
+ *
+ *  S<bool>   1 = Acknowledge commands from this port with "ok C<n>" credits.
+ *                The reply to M577 S1 is the first grant, the whole queue.
+ *            0 = Back to one "ok" per command.
+ *  B<count>  Credits to collect before returning them (1-BUFSIZE)
+ *
+ * With no parameters report the current mode.
+ */
+void GcodeSuite::M577() {
+  #if NUM_SERIAL > 1
+    const int16_t p = queue.port[queue.index_r];
+    if (p < 0) return;
+  #else
+    constexpr int16_t p = 0;
+  #endif
+
+  if (parser.seenval('B')) {
+    const uint8_t b = parser.value_byte();
+    if (WITHIN(b, 1, BUFSIZE))
+      queue.credit_batch = b;
+    else
+      SERIAL_ECHOLNPGM("?Batch (B) must be 1 to BUFSIZE.");
+  }
+
+  if (parser.seen('S'))
+    queue.set_credit_flow(p, parser.value_bool());
+  else if (!parser.seen('B')) {
+    SERIAL_ECHO_START();
+    SERIAL_ECHOLNPAIR("Credit flow ", queue.credit_flow[p] ? "on" : "off", " window ", int(BUFSIZE), " batch ", int(queue.credit_batch));
+  }
+}
+
+#endif // SERIAL_CREDIT_FLOW
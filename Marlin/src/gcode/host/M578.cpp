@@ -0,0 +1,66 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2019 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(SERIAL_PORT_SCHEDULER)
+
+#include "../gcode.h"
+#include "../queue.h"
+
+/**
+ * M578: Serial port scheduler
+ *
+ *  W<weight>  Lines queued from the print port for each line from the other
+ *  R          Reset the port statistics
+ *
+ * With no parameters report how each port has been served.
+ */
+void GcodeSuite::M578() {
+  if (parser.seenval('W')) {
+    const uint8_t w = parser.value_byte();
+    if (w)
+      queue.print_weight = w;
+    else
+      SERIAL_ECHOLNPGM("?Weight (W) must be 1 or more.");
+  }
+
+  if (parser.seen('R')) {
+    LOOP_L_N(p, NUM_SERIAL) {
+      GCodeQueue::port_stats_t &s = queue.port_stats[p];
+      s.lines = s.bytes = s.held = 0;
+    }
+  }
+  else if (!parser.seen('W')) {
+    SERIAL_ECHO_START();
+    SERIAL_ECHOLNPAIR("Print port weight ", int(queue.print_weight), " other port queue ", int(OTHER_PORT_QUEUE));
+    LOOP_L_N(p, NUM_SERIAL) {
+      const GCodeQueue::port_stats_t &s = queue.port_stats[p];
+      SERIAL_ECHO_START();
+      SERIAL_ECHOPAIR("Port ", int(p));
+      if (p == queue.print_port) SERIAL_ECHOPGM(" (print)");
+      SERIAL_ECHOLNPAIR(": ", s.lines, " lines ", s.bytes, " bytes ", int(s.queued), " queued, waited ", s.held, " times");
+    }
+  }
+}
+
+#endif // SERIAL_PORT_SCHEDULER
@@ -28,6 +28,10 @@
 
 #include "../Marlin.h"
 
+#if BOTH(GCODE_DECIMAL_SCANNER, MOTION_BENCHMARK)
+  #include "../feature/benchmark.h"
+#endif
+
 #if NUM_SERIAL > 1
   #include "queue.h"
 #endif
@@ -55,6 +59,11 @@ int GCodeParser::codenum;
   uint8_t GCodeParser::subcode;
 #endif
 
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+  const parsed_command_t *GCodeParser::record;
+  uint8_t GCodeParser::value_index;
+#endif
+
 #if ENABLED(GCODE_MOTION_MODES)
   int16_t GCodeParser::motion_mode_codenum = -1;
   #if USE_GCODE_SUBCODES
@@ -90,8 +99,36 @@ void GCodeParser::reset() {
     codebits = 0;                       // No codes yet
     //ZERO(param);                      // No parameters (should be safe to comment out this line)
   #endif
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    record = nullptr;                   // Parameters come from the text
+  #endif
 }
 
+#if ENABLED(GCODE_MOTION_MODES)
+
+  #if ENABLED(ARC_SUPPORT)
+    #define GTOP 3
+  #else
+    #define GTOP 1
+  #endif
+
+  // Remember G0-G3, G5, and G38 for lines that only have parameters
+  void GCodeParser::set_motion_mode() {
+    if (command_letter == 'G' && (codenum <= GTOP || codenum == 5
+                                    #if ENABLED(G38_PROBE_TARGET)
+                                      || codenum == 38
+                                    #endif
+                                 )
+    ) {
+      motion_mode_codenum = codenum;
+      #if USE_GCODE_SUBCODES
+        motion_mode_subcode = subcode;
+      #endif
+    }
+  }
+
+#endif
+
 // Populate all fields by parsing a single line of GCode
 // 58 bytes of SRAM are used to speed up seen/value
 void GCodeParser::parse(char *p) {
@@ -125,14 +162,6 @@ void GCodeParser::parse(char *p) {
     starpos[1] = '\0';
   }
 
-  #if ENABLED(GCODE_MOTION_MODES)
-    #if ENABLED(ARC_SUPPORT)
-      #define GTOP 3
-    #else
-      #define GTOP 1
-    #endif
-  #endif
-
   // Bail if the letter is not G, M, or T
   // (or a valid parameter for the current motion mode)
   switch (letter) {
@@ -179,17 +208,7 @@ void GCodeParser::parse(char *p) {
       while (*p == ' ') p++;
 
       #if ENABLED(GCODE_MOTION_MODES)
-        if (letter == 'G' && (codenum <= GTOP || codenum == 5
-                                #if ENABLED(G38_PROBE_TARGET)
-                                  || codenum == 38
-                                #endif
-                             )
-        ) {
-          motion_mode_codenum = codenum;
-          #if USE_GCODE_SUBCODES
-            motion_mode_subcode = subcode;
-          #endif
-        }
+        set_motion_mode();
       #endif
 
       break;
@@ -313,6 +332,204 @@ void GCodeParser::parse(char *p) {
   }
 }
 
+#if ENABLED(GCODE_DECIMAL_SCANNER)
+
+  /**
+   * Read a number as G-code writes it: [-+]?[0-9]*(.[0-9]*)?
+   * Up to 9 significant digits are kept in an integer mantissa, which is
+   * then divided by an exact power of ten. Up to 7 digits this rounds just
+   * like strtod. Longer numbers may be up to 2 units in the last place off.
+   */
+  float GCodeParser::scan_float(const char *p) {
+    static constexpr float pow10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+    #if ENABLED(MOTION_BENCHMARK)
+      const char * const start = p;
+    #endif
+
+    const bool neg = *p == '-';
+    if (neg || *p == '+') ++p;
+
+    uint32_t m = 0;
+    uint8_t digits = 0;
+    int8_t scale = 0;               // Power of ten to divide by
+    for (; NUMERIC(*p); ++p) {
+      if (digits < 9) {
+        m = m * 10 + (*p - '0');
+        if (m) digits++;
+      }
+      else
+        scale--;                    // Integer digits past the 9th only scale
+    }
+    if (*p == '.') {
+      for (++p; NUMERIC(*p); ++p) {
+        if (digits < 9) {
+          m = m * 10 + (*p - '0');
+          if (m) digits++;
+          scale++;
+        }
+      }
+    }
+
+    float f = m;
+    for (; scale > 10; scale -= 10) f /= pow10[10];
+    for (; scale < -10; scale += 10) f *= pow10[10];
+    f = scale < 0 ? f * pow10[-scale] : f / pow10[scale];
+    if (neg) f = -f;
+
+    #if ENABLED(MOTION_BENCHMARK)
+      benchmark.compare_float(start, f);
+    #endif
+    return f;
+  }
+
+  // Read [-+]?[0-9]*, wrapping around like strtoul for values out of range
+  int32_t GCodeParser::scan_long(const char *p) {
+    const bool neg = *p == '-';
+    if (neg || *p == '+') ++p;
+    uint32_t v = 0;
+    while (NUMERIC(*p)) v = v * 10 + (*p++ - '0');
+    return int32_t(neg ? 0UL - v : v);
+  }
+
+#endif // GCODE_DECIMAL_SCANNER
+
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+
+  /**
+   * Parse a line into a queue record, leaving the parser state alone so the
+   * command being run isn't disturbed. Return false for a line that has to be
+   * parsed from text when it runs: one with a string argument or a parameter
+   * without a value, a repeated parameter, more than PREPARSED_MAX_VALUES
+   * values, or no G, M, or T code. The line may be altered.
+   */
+  bool GCodeParser::preparse(char *p, parsed_command_t &cmd) {
+    cmd.letter = 0;
+
+    while (*p == ' ') ++p;
+    if (*p == 'N' && NUMERIC_SIGNED(p[1])) {
+      p += 2;
+      while (NUMERIC(*p)) ++p;
+      while (*p == ' ') ++p;
+    }
+
+    const char letter = *p++;
+    switch (letter) {
+      case 'G': case 'M': case 'T':
+      #if ENABLED(CANCEL_OBJECTS)
+        case 'O':
+      #endif
+        break;
+      default: return false;
+    }
+
+    while (*p == ' ') ++p;
+    if (!NUMERIC(*p)) return false;
+    uint16_t code = 0;
+    do { code *= 10, code += *p++ - '0'; } while (NUMERIC(*p));
+    uint8_t sub = 0;
+    #if USE_GCODE_SUBCODES
+      if (*p == '.') {
+        p++;
+        while (NUMERIC(*p)) sub *= 10, sub += *p++ - '0';
+      }
+    #endif
+
+    cmd.letter = letter;
+    cmd.codenum = code;
+    cmd.subcode = sub;
+
+    // Codes that take the rest of the line as a string
+    if (letter == 'M') switch (code) {
+      case 16: case 23: case 28: case 30: case 32: case 117: case 118: case 810 ... 819: case 928: return false;
+      default: break;
+    }
+    #if ENABLED(CNC_COORDINATE_SYSTEMS)
+      if (letter == 'G' && code == 53) return false;  // May chain another command
+    #endif
+
+    uint32_t bits = 0;
+    uint8_t ints = 0, count = 0;
+    for (;;) {
+      while (*p == ' ') ++p;
+      const char c = *p++;
+      if (c == '\0' || c == '*') break;
+      if (!WITHIN(c, 'A', 'Z')) return false;
+      while (*p == ' ') ++p;
+      if (!valid_float(p) || count >= PREPARSED_MAX_VALUES) return false;
+      const uint8_t ind = LETTER_BIT(c);
+      if (TEST32(bits, ind)) return false;
+
+      // Read the value the same way as value_float() and value_long()
+      char * const v = p;
+      bool is_int = true;
+      while (DECIMAL_SIGNED(*p)) if (*p++ == '.') is_int = false;
+      const char e = *p;
+      *p = '\0';
+
+      // Keep the values in letter order
+      const uint8_t i = __builtin_popcountl(bits & (_BV32(ind) - 1));
+      for (uint8_t j = count; j > i; --j) cmd.value[j] = cmd.value[j - 1];
+      ints = (ints & (_BV(i) - 1)) | ((ints >> i) << (i + 1));
+      if (is_int) {
+        #if ENABLED(GCODE_DECIMAL_SCANNER)
+          cmd.value[i].i = scan_long(v);
+        #else
+          cmd.value[i].i = strtol(v, nullptr, 10);
+        #endif
+        SBI(ints, i);
+      }
+      else {
+        #if ENABLED(GCODE_DECIMAL_SCANNER)
+          cmd.value[i].f = scan_float(v);
+        #else
+          cmd.value[i].f = strtof(v, nullptr);
+        #endif
+      }
+
+      *p = e;
+      SBI32(bits, ind);
+      count++;
+    }
+
+    cmd.codebits = bits;
+    cmd.intbits = ints;
+    cmd.text = NO_COMMAND_TEXT;
+    return true;
+  }
+
+  void GCodeParser::load(const parsed_command_t &cmd) {
+    record = &cmd;
+    value_index = 0xFF;
+    command_ptr = string_arg = nullptr;
+    command_letter = cmd.letter;
+    codenum = cmd.codenum;
+    #if USE_GCODE_SUBCODES
+      subcode = cmd.subcode;
+    #endif
+    codebits = cmd.codebits;
+    #if ENABLED(GCODE_MOTION_MODES)
+      set_motion_mode();
+    #endif
+  }
+
+  void GCodeParser::echo_command() {
+    if (!record) { SERIAL_ECHO(command_ptr); return; }
+    SERIAL_CHAR(command_letter);
+    SERIAL_ECHO(codenum);
+    #if USE_GCODE_SUBCODES
+      if (subcode) { SERIAL_CHAR('.'); SERIAL_ECHO(int(subcode)); }
+    #endif
+    for (uint8_t i = 0, n = 0; i < 26; i++) {
+      if (!TEST32(codebits, i)) continue;
+      SERIAL_CHAR(' ');
+      SERIAL_CHAR('A' + i);
+      if (TEST(record->intbits, n)) SERIAL_ECHO(record->value[n].i); else SERIAL_ECHO(record->value[n].f);
+      n++;
+    }
+  }
+
+#endif // PREPARSED_COMMAND_QUEUE
+
 #if ENABLED(CNC_COORDINATE_SYSTEMS)
 
   // Parse the next parameter as a new command
@@ -335,7 +552,13 @@ void GCodeParser::parse(char *p) {
 
 void GCodeParser::unknown_command_error() {
   SERIAL_ECHO_START();
-  SERIAL_ECHOLNPAIR(MSG_UNKNOWN_COMMAND, command_ptr, "\"");
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    SERIAL_ECHOPGM(MSG_UNKNOWN_COMMAND);
+    echo_command();
+    SERIAL_ECHOLNPGM("\"");
+  #else
+    SERIAL_ECHOLNPAIR(MSG_UNKNOWN_COMMAND, command_ptr, "\"");
+  #endif
 }
 
 #if ENABLED(DEBUG_GCODE_PARSER)
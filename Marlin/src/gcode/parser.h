@@ -42,6 +42,28 @@
   typedef enum : uint8_t { LINEARUNIT_MM, LINEARUNIT_INCH } LinearUnit;
 #endif
 
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+
+  #define NO_COMMAND_TEXT 0xFF
+
+  /**
+   * A queued command, parsed when it was received.
+   * Every parameter in 'codebits' has a value, stored in letter order.
+   * Commands that have to be parsed from text (string arguments, flags
+   * without a value, etc.) keep it in a queue text line instead.
+   */
+  typedef struct {
+    char letter;                          // G, M, T, or 0 if unknown
+    uint8_t subcode,                      // .1
+            text,                         // Queue text line, or NO_COMMAND_TEXT
+            intbits;                      // Values that were written as integers
+    uint16_t codenum;                     // 123
+    uint32_t codebits;                    // Parameters A-Z
+    union { float f; int32_t i; } value[PREPARSED_MAX_VALUES];
+  } parsed_command_t;
+
+#endif
+
 /**
  * GCode parser
  *
@@ -66,6 +88,18 @@ private:
     static char *command_args;      // Args start here, for slow scan
   #endif
 
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    static uint8_t value_index;     // Set by seen, for a pre-parsed command
+    static inline bool value_is_int() { return TEST(record->intbits, value_index); }
+    static inline int32_t record_long() {
+      return value_is_int() ? record->value[value_index].i : int32_t(record->value[value_index].f);
+    }
+  #endif
+
+  #if ENABLED(GCODE_MOTION_MODES)
+    static void set_motion_mode();
+  #endif
+
 public:
 
   // Global states for GCode-level units features
@@ -88,6 +122,9 @@ public:
   #if USE_GCODE_SUBCODES
     static uint8_t subcode;               // .1
   #endif
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    static const parsed_command_t *record; // The queued command, if it wasn't parsed from text
+  #endif
 
   #if ENABLED(GCODE_MOTION_MODES)
     static int16_t motion_mode_codenum;
@@ -114,6 +151,12 @@ public:
     return valid_signless(p) || ((p[0] == '-' || p[0] == '+') && valid_signless(&p[1])); // [-+]?.?[0-9]
   }
 
+  #if ENABLED(GCODE_DECIMAL_SCANNER)
+    // Read a number without libc. Exponents are not read.
+    static float scan_float(const char *p);
+    static int32_t scan_long(const char *p);
+  #endif
+
   #if ENABLED(FASTER_GCODE_PARSER)
 
     FORCE_INLINE static bool valid_int(const char * const p) {
@@ -142,6 +185,12 @@ public:
       if (ind >= COUNT(param)) return false; // Only A-Z
       const bool b = TEST32(codebits, ind);
       if (b) {
+        #if ENABLED(PREPARSED_COMMAND_QUEUE)
+          if (record) {
+            value_index = __builtin_popcountl(codebits & (_BV32(ind) - 1));
+            return b;
+          }
+        #endif
         char * const ptr = command_ptr + param[ind];
         value_ptr = param[ind] && valid_float(ptr) ? ptr : nullptr;
       }
@@ -212,40 +261,79 @@ public:
   // This uses 54 bytes of SRAM to speed up seen/value
   static void parse(char * p);
 
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    // Parse a line for the queue. Return false if it has to keep its text.
+    static bool preparse(char * p, parsed_command_t &cmd);
+    // Populate all fields from a pre-parsed command
+    static void load(const parsed_command_t &cmd);
+    // Print the current command (reconstructed from a pre-parsed one)
+    static void echo_command();
+  #endif
+
   #if ENABLED(CNC_COORDINATE_SYSTEMS)
     // Parse the next parameter as a new command
     static bool chain();
   #endif
 
   // The code value pointer was set
-  FORCE_INLINE static bool has_value() { return value_ptr != nullptr; }
+  FORCE_INLINE static bool has_value() {
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      if (record) return value_index != 0xFF;
+    #endif
+    return value_ptr != nullptr;
+  }
 
   // Seen a parameter with a value
   static inline bool seenval(const char c) { return seen(c) && has_value(); }
 
   // Float removes 'E' to prevent scientific notation interpretation
   static inline float value_float() {
-    if (value_ptr) {
-      char *e = value_ptr;
-      for (;;) {
-        const char c = *e;
-        if (c == '\0' || c == ' ') break;
-        if (c == 'E' || c == 'e') {
-          *e = '\0';
-          const float ret = strtof(value_ptr, nullptr);
-          *e = c;
-          return ret;
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      if (record) return !has_value() ? 0 : value_is_int() ? record->value[value_index].i : record->value[value_index].f;
+    #endif
+    #if ENABLED(GCODE_DECIMAL_SCANNER)
+      return value_ptr ? scan_float(value_ptr) : 0;
+    #else
+      if (value_ptr) {
+        char *e = value_ptr;
+        for (;;) {
+          const char c = *e;
+          if (c == '\0' || c == ' ') break;
+          if (c == 'E' || c == 'e') {
+            *e = '\0';
+            const float ret = strtof(value_ptr, nullptr);
+            *e = c;
+            return ret;
+          }
+          ++e;
         }
-        ++e;
+        return strtof(value_ptr, nullptr);
       }
-      return strtof(value_ptr, nullptr);
-    }
-    return 0;
+      return 0;
+    #endif
   }
 
   // Code value as a long or ulong
-  static inline int32_t value_long() { return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L; }
-  static inline uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL; }
+  static inline int32_t value_long() {
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      if (record) return has_value() ? record_long() : 0L;
+    #endif
+    #if ENABLED(GCODE_DECIMAL_SCANNER)
+      return value_ptr ? scan_long(value_ptr) : 0L;
+    #else
+      return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L;
+    #endif
+  }
+  static inline uint32_t value_ulong() {
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      if (record) return has_value() ? uint32_t(record_long()) : 0UL;
+    #endif
+    #if ENABLED(GCODE_DECIMAL_SCANNER)
+      return value_ptr ? uint32_t(scan_long(value_ptr)) : 0UL;
+    #else
+      return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL;
+    #endif
+  }
 
   // Code value for use as time
   static inline millis_t value_millis() { return value_ulong(); }
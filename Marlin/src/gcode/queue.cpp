@@ -39,7 +39,7 @@ GCodeQueue queue;
   #include "../feature/leds/printer_event_leds.h"
 #endif
 
-#if ENABLED(BINARY_FILE_TRANSFER)
+#if HAS_BINARY_STREAM
   #include "../feature/binary_protocol.h"
 #endif
 
@@ -47,6 +47,10 @@ GCodeQueue queue;
   #include "../feature/power_loss_recovery.h"
 #endif
 
+#if ENABLED(MOTION_BENCHMARK)
+  #include "../feature/benchmark.h"
+#endif
+
 /**
  * GCode line number handling. Hosts may opt to include line numbers when
  * sending commands to Marlin, and lines will be checked for sequentiality.
@@ -67,7 +71,31 @@ uint8_t GCodeQueue::length = 0,  // Count of commands in the queue
         GCodeQueue::index_r = 0, // Ring buffer read position
         GCodeQueue::index_w = 0; // Ring buffer write position
 
-char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+
+  parsed_command_t GCodeQueue::command_buffer[BUFSIZE];
+
+  char GCodeQueue::text_buffer[PREPARSED_TEXT_LINES][MAX_CMD_SIZE];
+  uint8_t GCodeQueue::text_length = 0,  // Count of text lines in use
+          GCodeQueue::text_index_w = 0; // Text line ring write position
+
+  #if ENABLED(SDSUPPORT)
+    // Commands after a queued M28 / M928 keep their text, to be written to SD
+    static uint8_t sd_writes_queued = 0;
+    FORCE_INLINE bool is_sd_write(const parsed_command_t &cmd) {
+      return cmd.letter == 'M' && (cmd.codenum == 28 || cmd.codenum == 928);
+    }
+  #endif
+
+  #if ENABLED(ADVANCED_OK)
+    static long line_N[BUFSIZE]; // Line number of each command, or -1
+  #endif
+
+#else
+
+  char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
+
+#endif
 
 /*
  * The port that the command was received on
@@ -76,6 +104,25 @@ char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
   int16_t GCodeQueue::port[BUFSIZE];
 #endif
 
+#if ENABLED(SERIAL_CREDIT_FLOW)
+  bool GCodeQueue::credit_flow[NUM_SERIAL];               // Port is in credit mode
+  uint8_t GCodeQueue::credit_batch = CREDIT_FLOW_BATCH,   // Credits to collect before returning them
+          GCodeQueue::credits[NUM_SERIAL];                // Credits collected for each port
+#endif
+
+#if ENABLED(SERIAL_PORT_SCHEDULER)
+  GCodeQueue::port_stats_t GCodeQueue::port_stats[NUM_SERIAL];
+  int8_t GCodeQueue::print_port = -1;                     // Port that sent the latest move
+  uint8_t GCodeQueue::print_weight = PRINT_PORT_WEIGHT,   // Lines from the print port per line from the other
+          GCodeQueue::turns[NUM_SERIAL];                  // Lines each port may still queue this round
+#endif
+
+#if ENABLED(SERIAL_SELECTIVE_RESEND)
+  GCodeQueue::held_line_t GCodeQueue::held[RESEND_BUFFER_LINES]; // Lines received after a gap
+  uint8_t GCodeQueue::held_count = 0;
+  long GCodeQueue::resend_N = 0;                          // Last line number asked for with "Resend:"
+#endif
+
 /**
  * Serial command injection
  */
@@ -83,6 +130,26 @@ char GCodeQueue::command_buffer[BUFSIZE][MAX_CMD_SIZE];
 // Number of characters read in the current line of serial input
 static int serial_count[NUM_SERIAL] = { 0 };
 
+// Checksum of the current line, updated as each character is stored, and its
+// value at the last '*' with the position of that '*' (0 if there's none yet)
+static uint8_t serial_checksum[NUM_SERIAL] = { 0 }, star_checksum[NUM_SERIAL] = { 0 };
+static int serial_star[NUM_SERIAL] = { 0 };
+
+inline void store_serial_char(char * const line, const uint8_t i, const char c) {
+  if (c == ' ' && !serial_count[i]) return;   // Skip leading spaces
+  if (c == '*') {
+    serial_star[i] = serial_count[i];
+    star_checksum[i] = serial_checksum[i];
+  }
+  serial_checksum[i] ^= c;
+  line[serial_count[i]++] = c;
+}
+
+inline void reset_serial_line(const uint8_t i) {
+  serial_count[i] = serial_star[i] = 0;
+  serial_checksum[i] = 0;
+}
+
 bool send_ok[BUFSIZE];
 
 /**
@@ -108,7 +175,24 @@ bool GCodeQueue::has_commands_queued() {
  * Clear the Marlin command queue
  */
 void GCodeQueue::clear() {
+  #if ENABLED(SERIAL_CREDIT_FLOW)
+    // The host gets back the credit of every dropped command
+    while (length) {
+      length--;
+      release_credit(index_r);
+      if (++index_r >= BUFSIZE) index_r = 0;
+    }
+  #endif
   index_r = index_w = length = 0;
+  #if ENABLED(SERIAL_PORT_SCHEDULER)
+    LOOP_L_N(p, NUM_SERIAL) port_stats[p].queued = 0;
+  #endif
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    text_index_w = text_length = 0;
+    #if ENABLED(SDSUPPORT)
+      sd_writes_queued = 0;
+    #endif
+  #endif
 }
 
 /**
@@ -123,6 +207,9 @@ void GCodeQueue::_commit_command(bool say_ok
   #if NUM_SERIAL > 1
     port[index_w] = p;
   #endif
+  #if ENABLED(SERIAL_PORT_SCHEDULER)
+    if (p >= 0) port_stats[p].queued++;
+  #endif
   #if ENABLED(POWER_LOSS_RECOVERY)
     recovery.commit_sdpos(index_w);
   #endif
@@ -130,6 +217,36 @@ void GCodeQueue::_commit_command(bool say_ok
   length++;
 }
 
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+
+  /**
+   * Parse a command into the next queue record. Keep its text
+   * if it can't be pre-parsed or may have to be written to SD.
+   * Return false if no text line is free for it.
+   */
+  bool GCodeQueue::store_command(const char* cmd) {
+    parsed_command_t &rec = command_buffer[index_w];
+    char line[MAX_CMD_SIZE];
+    strcpy(line, cmd);
+    if (parser.preparse(line, rec)
+      #if ENABLED(SDSUPPORT)
+        && !sd_writes_queued && !card.flag.saving && !card.flag.logging
+      #endif
+    ) return true;
+
+    if (text_length >= PREPARSED_TEXT_LINES) return false;
+    #if ENABLED(SDSUPPORT)
+      if (is_sd_write(rec)) sd_writes_queued++;
+    #endif
+    rec.text = text_index_w;
+    strcpy(text_buffer[text_index_w], cmd);
+    if (++text_index_w >= PREPARSED_TEXT_LINES) text_index_w = 0;
+    text_length++;
+    return true;
+  }
+
+#endif
+
 /**
  * Copy a command from RAM into the main command buffer.
  * Return true if the command was successfully added.
@@ -141,7 +258,14 @@ bool GCodeQueue::_enqueue(const char* cmd, bool say_ok/*=false*/
   #endif
 ) {
   if (*cmd == ';' || length >= BUFSIZE) return false;
-  strcpy(command_buffer[index_w], cmd);
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    if (!store_command(cmd)) return false;
+    #if ENABLED(ADVANCED_OK)
+      line_N[index_w] = *cmd == 'N' ? strtol(cmd + 1, nullptr, 10) : -1;
+    #endif
+  #else
+    strcpy(command_buffer[index_w], cmd);
+  #endif
   _commit_command(say_ok
     #if NUM_SERIAL > 1
       , pn
@@ -246,36 +370,80 @@ void GCodeQueue::ok_to_send() {
     PORT_REDIRECT(pn);
   #endif
   if (!send_ok[index_r]) return;
+  #if ENABLED(SERIAL_CREDIT_FLOW)
+    #if NUM_SERIAL == 1
+      constexpr int16_t pn = 0;
+    #endif
+    if (credit_flow[pn]) return;    // Credit is returned once the command is done
+  #endif
   SERIAL_ECHOPGM(MSG_OK);
   #if ENABLED(ADVANCED_OK)
-    char* p = command_buffer[index_r];
-    if (*p == 'N') {
-      SERIAL_ECHO(' ');
-      SERIAL_ECHO(*p++);
-      while (NUMERIC_SIGNED(*p))
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      if (line_N[index_r] >= 0) SERIAL_ECHOPAIR(" N", line_N[index_r]);
+    #else
+      char* p = command_buffer[index_r];
+      if (*p == 'N') {
+        SERIAL_ECHO(' ');
         SERIAL_ECHO(*p++);
-    }
+        while (NUMERIC_SIGNED(*p))
+          SERIAL_ECHO(*p++);
+      }
+    #endif
     SERIAL_ECHOPGM(" P"); SERIAL_ECHO(int(BLOCK_BUFFER_SIZE - planner.movesplanned() - 1));
     SERIAL_ECHOPGM(" B"); SERIAL_ECHO(BUFSIZE - length);
   #endif
   SERIAL_EOL();
 }
 
-/**
- * Send a "Resend: nnn" message to the host to
- * indicate that a command needs to be re-sent.
- */
-void GCodeQueue::flush_and_request_resend() {
-  #if NUM_SERIAL > 1
-    const int16_t p = port[index_r];
-    if (p < 0) return;
+#if ENABLED(SERIAL_CREDIT_FLOW)
+
+  /**
+   * Turn credit mode on or off for a port. The host waits for the reply
+   * to M577, so only the M577 itself is in the queue. When it's done the
+   * host gets the whole queue as credit.
+   */
+  void GCodeQueue::set_credit_flow(const int8_t p, const bool on) {
+    if (p < 0 || on == credit_flow[p]) return;
+    if (on)
+      credits[p] = BUFSIZE - 1;
+    else
+      return_credits(p);
+    credit_flow[p] = on;
+  }
+
+  /**
+   * Send "ok C<n>" to return the credits collected for a port
+   */
+  void GCodeQueue::return_credits(const int8_t p) {
+    if (!credits[p]) return;
     PORT_REDIRECT(p);
-  #endif
-  SERIAL_FLUSH();
-  SERIAL_ECHOPGM(MSG_RESEND);
-  SERIAL_ECHOLN(last_N + 1);
-  ok_to_send();
-}
+    SERIAL_ECHOPGM(MSG_OK);
+    SERIAL_ECHOPAIR(" C", int(credits[p]));
+    #if ENABLED(ADVANCED_OK)
+      SERIAL_ECHOPGM(" P"); SERIAL_ECHO(int(BLOCK_BUFFER_SIZE - planner.movesplanned() - 1));
+      SERIAL_ECHOPGM(" B"); SERIAL_ECHO(BUFSIZE - length);
+    #endif
+    SERIAL_EOL();
+    credits[p] = 0;
+  }
+
+  /**
+   * Collect the credit of the serial command in slot 'i', which has been
+   * freed. Return credits in batches, or all of them once the queue is empty.
+   */
+  void GCodeQueue::release_credit(const uint8_t i) {
+    if (!send_ok[i]) return;
+    #if NUM_SERIAL > 1
+      const int16_t p = port[i];
+      if (p < 0) return;
+    #else
+      constexpr int16_t p = 0;
+    #endif
+    if (!credit_flow[p]) return;
+    if (++credits[p] >= credit_batch || !length) return_credits(p);
+  }
+
+#endif // SERIAL_CREDIT_FLOW
 
 inline bool serial_data_available() {
   return false
@@ -286,6 +454,16 @@ inline bool serial_data_available() {
   ;
 }
 
+inline bool serial_data_available(const uint8_t index) {
+  switch (index) {
+    case 0: return MYSERIAL0.available();
+    #if NUM_SERIAL > 1
+      case 1: return MYSERIAL1.available();
+    #endif
+    default: return false;
+  }
+}
+
 inline int read_serial(const uint8_t index) {
   switch (index) {
     case 0: return MYSERIAL0.read();
@@ -296,16 +474,152 @@ inline int read_serial(const uint8_t index) {
   }
 }
 
+/**
+ * Send a "Resend: nnn" message to the host to
+ * indicate that a command needs to be re-sent.
+ */
+void GCodeQueue::flush_and_request_resend(const int8_t p) {
+  if (p < 0) return;
+  PORT_REDIRECT(p);
+  #if ENABLED(SERIAL_SELECTIVE_RESEND)
+    // Keep the RX buffer. Good lines after the gap will be held.
+    request_resend(p);
+  #else
+    #if ENABLED(SERIAL_CREDIT_FLOW)
+      // Lines dropped from the RX buffer get their credit back with the resend
+      if (credit_flow[p])
+        for (int c; (c = read_serial(p)) != -1;) if (c == '\n') credits[p]++;
+    #endif
+    SERIAL_FLUSH();
+    SERIAL_ECHOPGM(MSG_RESEND);
+    SERIAL_ECHOLN(last_N + 1);
+  #endif
+  #if ENABLED(SERIAL_CREDIT_FLOW)
+    if (credit_flow[p]) return return_credits(p);
+  #endif
+  ok_to_send();
+}
+
 void GCodeQueue::gcode_line_error(PGM_P const err, const int8_t port) {
   PORT_REDIRECT(port);
   SERIAL_ERROR_START();
   serialprintPGM(err);
   SERIAL_ECHOLN(last_N);
-  while (read_serial(port) != -1);           // clear out the RX buffer
-  flush_and_request_resend();
-  serial_count[port] = 0;
+  #if ENABLED(SERIAL_SELECTIVE_RESEND)
+    #if ENABLED(SERIAL_CREDIT_FLOW)
+      if (credit_flow[port]) credits[port]++;  // The bad line's credit goes back with the resend
+    #endif
+  #else
+    #if ENABLED(SERIAL_CREDIT_FLOW)
+      if (credit_flow[port]) credits[port]++;  // The bad line's credit goes back with the resend
+      else
+    #endif
+        while (read_serial(port) != -1);       // clear out the RX buffer
+  #endif
+  flush_and_request_resend(port);
+  reset_serial_line(port);
 }
 
+#if ENABLED(SERIAL_SELECTIVE_RESEND)
+
+  /**
+   * Ask the host for the line after the last one received, without
+   * dropping anything. Lines held in the meantime keep their "ok".
+   */
+  void GCodeQueue::request_resend(const int8_t p) {
+    PORT_REDIRECT(p);
+    SERIAL_ECHOPGM(MSG_RESEND);
+    SERIAL_ECHOLN(last_N + 1);
+    resend_N = last_N + 1;
+  }
+
+  /**
+   * Acknowledge a line that was received before, sent again after a resend
+   */
+  void GCodeQueue::skip_line(const int8_t p) {
+    #if ENABLED(SERIAL_CREDIT_FLOW)
+      if (credit_flow[p]) {
+        if (++credits[p] >= credit_batch || !length) return_credits(p);
+        return;
+      }
+    #endif
+    PORT_REDIRECT(p);
+    SERIAL_ECHOLNPGM(MSG_OK);
+  }
+
+  /**
+   * Hold a good line that came after a gap and ask for the missing line.
+   * Return false if it's too far ahead or there's no room to keep it.
+   */
+  bool GCodeQueue::hold_line(const char* cmd, const long N, const int8_t p) {
+    LOOP_L_N(h, held_count) if (held[h].N == N) { skip_line(p); return true; }
+    if (held_count >= RESEND_BUFFER_LINES || N > last_N + 1 + RESEND_BUFFER_LINES) return false;
+    held_line_t &hl = held[held_count++];
+    hl.N = N;
+    hl.port = p;
+    strcpy(hl.line, cmd);
+    if (resend_N != last_N + 1) request_resend(p);
+    return true;
+  }
+
+  /**
+   * Queue the held lines that now follow on, while there's room.
+   * If a line is still missing before the rest, ask for that one.
+   */
+  void GCodeQueue::release_held_lines() {
+    while (held_count) {
+      uint8_t h = 0;
+      while (h < held_count && held[h].N != last_N + 1) h++;
+      if (h == held_count) {
+        if (resend_N != last_N + 1) request_resend(held[0].port);
+        return;
+      }
+      if (!has_space()) return;
+      last_N = held[h].N;
+      _enqueue(held[h].line, true
+        #if NUM_SERIAL > 1
+          , held[h].port
+        #endif
+      );
+      if (h != --held_count) held[h] = held[held_count];
+    }
+  }
+
+#endif // SERIAL_SELECTIVE_RESEND
+
+#if ENABLED(SERIAL_PORT_SCHEDULER)
+
+  /**
+   * May port 'p' be read now? Not while the other port owns the print and 'p'
+   * has its share of the queue, nor once 'p' has used up its turns while
+   * another port still has turns and a line coming. When every port with
+   * data is out of turns a new round starts.
+   */
+  bool GCodeQueue::port_ready(const uint8_t p) {
+    #define PORT_LIMITED(P) (print_port >= 0 && (P) != print_port && port_stats[P].queued >= OTHER_PORT_QUEUE)
+    if (PORT_LIMITED(p)) return false;
+    if (turns[p]) return true;
+    LOOP_L_N(o, NUM_SERIAL)
+      if (o != p && turns[o] && !PORT_LIMITED(o) && serial_data_available(o)) return false;
+    LOOP_L_N(o, NUM_SERIAL) turns[o] = o == print_port ? print_weight : 1;
+    return true;
+  }
+
+  /**
+   * A line from port 'p' was queued. A move makes it the print port.
+   */
+  void GCodeQueue::port_line_queued(const uint8_t p, const char *cmd) {
+    port_stats[p].lines++;
+    if (turns[p]) turns[p]--;
+    if (*cmd == 'N') {
+      do cmd++; while (NUMERIC(*cmd));
+      while (*cmd == ' ') cmd++;
+    }
+    if (cmd[0] == 'G' && WITHIN(cmd[1], '0', '3') && !NUMERIC(cmd[2])) print_port = p;
+  }
+
+#endif // SERIAL_PORT_SCHEDULER
+
 FORCE_INLINE bool is_M29(const char * const cmd) {  // matches "M29" & "M29 ", but not "M290", etc
   const char * const m29 = strstr_P(cmd, PSTR("M29"));
   return m29 && !NUMERIC(m29[3]);
@@ -324,18 +638,22 @@ void GCodeQueue::get_serial_commands() {
               #endif
             ;
 
-  #if ENABLED(BINARY_FILE_TRANSFER)
-    if (card.flag.binary_mode) {
+  #if HAS_BINARY_STREAM
+    if (BinaryStream::active) {
       /**
-       * For binary stream file transfer, use serial_line_buffer as the working
+       * For the binary stream, use serial_line_buffer as the working
        * receive buffer (which limits the packet size to MAX_CMD_SIZE).
        * The receive buffer also limits the packet size for reliable transmission.
        */
-      binaryStream[card.transfer_port_index].receive(serial_line_buffer[card.transfer_port_index]);
+      binaryStream[BinaryStream::port].receive(serial_line_buffer[BinaryStream::port]);
       return;
     }
   #endif
 
+  #if ENABLED(SERIAL_SELECTIVE_RESEND)
+    release_held_lines();
+  #endif
+
   // If the command buffer is empty for too long,
   // send "wait" to indicate Marlin is still waiting.
   #if NO_TIMEOUTS > 0
@@ -350,11 +668,30 @@ void GCodeQueue::get_serial_commands() {
   /**
    * Loop while serial characters are incoming and the queue is not full
    */
-  while (length < BUFSIZE && serial_data_available()) {
+  #if ENABLED(SERIAL_PORT_SCHEDULER)
+    bool waiting[NUM_SERIAL] = { false };
+  #endif
+
+  while (has_space() && serial_data_available()) {
+    #if ENABLED(SERIAL_PORT_SCHEDULER)
+      bool port_read = false;
+    #endif
     for (uint8_t i = 0; i < NUM_SERIAL; ++i) {
+      #if ENABLED(SERIAL_PORT_SCHEDULER)
+        if (!port_ready(i)) {
+          if (!waiting[i] && serial_data_available(i)) { waiting[i] = true; port_stats[i].held++; }
+          continue;
+        }
+      #endif
+
       int c;
       if ((c = read_serial(i)) < 0) continue;
 
+      #if ENABLED(SERIAL_PORT_SCHEDULER)
+        port_read = true;
+        port_stats[i].bytes++;
+      #endif
+
       char serial_char = c;
 
       /**
@@ -372,11 +709,11 @@ void GCodeQueue::get_serial_commands() {
         if (!serial_count[i]) { thermalManager.manage_heater(); continue; }
 
         serial_line_buffer[i][serial_count[i]] = 0;       // Terminate string
-        serial_count[i] = 0;                              // Reset buffer
+        const int star = serial_star[i];                  // Leading spaces were never stored
+        const uint8_t checksum = star_checksum[i];
+        reset_serial_line(i);                             // Reset buffer
 
         char* command = serial_line_buffer[i];
-
-        while (*command == ' ') command++;                // Skip leading spaces
         char *npos = (*command == 'N') ? command : nullptr;  // Require the N parameter to start the line
 
         if (npos) {
@@ -390,18 +727,28 @@ void GCodeQueue::get_serial_commands() {
 
           gcode_N = strtol(npos + 1, nullptr, 10);
 
-          if (gcode_N != last_N + 1 && !M110)
-            return gcode_line_error(PSTR(MSG_ERR_LINE_NO), i);
+          #if DISABLED(SERIAL_SELECTIVE_RESEND)
+            if (gcode_N != last_N + 1 && !M110)
+              return gcode_line_error(PSTR(MSG_ERR_LINE_NO), i);
+          #endif
 
-          char *apos = strrchr(command, '*');
-          if (apos) {
-            uint8_t checksum = 0, count = uint8_t(apos - command);
-            while (count) checksum ^= command[--count];
-            if (strtol(apos + 1, nullptr, 10) != checksum)
-              return gcode_line_error(PSTR(MSG_ERR_CHECKSUM_MISMATCH), i);
-          }
-          else
+          // The checksum of everything before the last '*', taken as it arrived
+          if (!star)
             return gcode_line_error(PSTR(MSG_ERR_NO_CHECKSUM), i);
+          if (strtol(command + star + 1, nullptr, 10) != checksum)
+            return gcode_line_error(PSTR(MSG_ERR_CHECKSUM_MISMATCH), i);
+
+          #if ENABLED(SERIAL_SELECTIVE_RESEND)
+            if (M110)
+              held_count = 0;                             // Line numbers start over
+            else if (gcode_N != last_N + 1) {
+              if (gcode_N <= last_N)
+                skip_line(i);                             // Already received
+              else if (!hold_line(command, gcode_N, i))
+                return gcode_line_error(PSTR(MSG_ERR_LINE_NO), i);
+              continue;
+            }
+          #endif
 
           last_N = gcode_N;
         }
@@ -454,6 +801,14 @@ void GCodeQueue::get_serial_commands() {
             , i
           #endif
         );
+
+        #if ENABLED(SERIAL_PORT_SCHEDULER)
+          port_line_queued(i, command);
+        #endif
+
+        #if ENABLED(SERIAL_SELECTIVE_RESEND)
+          release_held_lines();                           // Lines it was holding up
+        #endif
       }
       else if (serial_count[i] >= MAX_CMD_SIZE - 1) {
         // Keep fetching, but ignore normal characters beyond the max length
@@ -466,7 +821,7 @@ void GCodeQueue::get_serial_commands() {
             && !serial_comment_paren_mode[i]
           #endif
         )
-          serial_line_buffer[i][serial_count[i]++] = (char)c;
+          store_serial_char(serial_line_buffer[i], i, (char)c);
       }
       else { // it's not a newline, carriage return or escape char
         if (serial_char == ';') serial_comment_mode[i] = true;
@@ -478,9 +833,13 @@ void GCodeQueue::get_serial_commands() {
           #if ENABLED(PAREN_COMMENTS)
             && ! serial_comment_paren_mode[i]
           #endif
-        ) serial_line_buffer[i][serial_count[i]++] = serial_char;
+        ) store_serial_char(serial_line_buffer[i], i, serial_char);
       }
     } // for NUM_SERIAL
+
+    #if ENABLED(SERIAL_PORT_SCHEDULER)
+      if (!port_read) break;                              // Ports with data have to wait
+    #endif
   } // queue has space, serial has data
 }
 
@@ -501,6 +860,13 @@ void GCodeQueue::get_serial_commands() {
 
     if (!IS_SD_PRINTING()) return;
 
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      static char sd_line_buffer[MAX_CMD_SIZE];
+      #define SD_LINE sd_line_buffer
+    #else
+      #define SD_LINE command_buffer[index_w]
+    #endif
+
     /**
      * '#' stops reading from SD to the buffer prematurely, so procedural
      * macro calls are possible. If it occurs, stop_buffering is triggered
@@ -512,7 +878,7 @@ void GCodeQueue::get_serial_commands() {
 
     uint16_t sd_count = 0;
     bool card_eof = card.eof();
-    while (length < BUFSIZE && !card_eof && !stop_buffering) {
+    while (has_space() && !card_eof && !stop_buffering) {
       const int16_t n = card.get();
       char sd_char = (char)n;
       card_eof = card.eof();
@@ -559,10 +925,14 @@ void GCodeQueue::get_serial_commands() {
         // Skip empty lines and comments
         if (!sd_count) { thermalManager.manage_heater(); continue; }
 
-        command_buffer[index_w][sd_count] = '\0'; // terminate string
+        SD_LINE[sd_count] = '\0'; // terminate string
         sd_count = 0; // clear sd line buffer
 
-        _commit_command(false);
+        #if ENABLED(PREPARSED_COMMAND_QUEUE)
+          _enqueue(SD_LINE);
+        #else
+          _commit_command(false);
+        #endif
 
         #if ENABLED(POWER_LOSS_RECOVERY)
           recovery.cmd_sdpos = card.getIndex(); // Prime for the next _commit_command
@@ -584,7 +954,7 @@ void GCodeQueue::get_serial_commands() {
           #if ENABLED(PAREN_COMMENTS)
             && ! sd_comment_paren_mode
           #endif
-        ) command_buffer[index_w][sd_count++] = sd_char;
+        ) SD_LINE[sd_count++] = sd_char;
       }
     }
   }
@@ -619,8 +989,14 @@ void GCodeQueue::advance() {
 
   #if ENABLED(SDSUPPORT)
 
-    if (card.flag.saving) {
-      char* command = command_buffer[index_r];
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      // Commands queued for SD writing have kept their text
+      if (card.flag.saving && command_buffer[index_r].text != NO_COMMAND_TEXT) {
+        char* command = text_buffer[command_buffer[index_r].text];
+    #else
+      if (card.flag.saving) {
+        char* command = command_buffer[index_r];
+    #endif
       if (is_M29(command)) {
         // M29 closes the file
         card.closefile();
@@ -658,7 +1034,25 @@ void GCodeQueue::advance() {
 
   // The queue may be reset by a command handler or by code invoked by idle() within a handler
   if (length) {
+    #if ENABLED(PREPARSED_COMMAND_QUEUE)
+      const parsed_command_t &cmd = command_buffer[index_r];
+      if (cmd.text != NO_COMMAND_TEXT) {
+        text_length--;
+        #if ENABLED(SDSUPPORT)
+          if (sd_writes_queued && is_sd_write(cmd)) sd_writes_queued--;
+        #endif
+      }
+      #if ENABLED(MOTION_BENCHMARK)
+        if (cmd.text != NO_COMMAND_TEXT) benchmark.text_commands++; else benchmark.preparsed_commands++;
+      #endif
+    #endif
     --length;
+    #if ENABLED(SERIAL_PORT_SCHEDULER)
+      if (port[index_r] >= 0) port_stats[port[index_r]].queued--;
+    #endif
+    #if ENABLED(SERIAL_CREDIT_FLOW)
+      release_credit(index_r);
+    #endif
     if (++index_r >= BUFSIZE) index_r = 0;
   }
 
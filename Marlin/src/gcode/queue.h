@@ -28,6 +28,10 @@
 
 #include "../inc/MarlinConfig.h"
 
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+  #include "parser.h"
+#endif
+
 class GCodeQueue {
 public:
   /**
@@ -51,7 +55,22 @@ public:
   static uint8_t length,  // Count of commands in the queue
                  index_r; // Ring buffer read position
 
-  static char command_buffer[BUFSIZE][MAX_CMD_SIZE];
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    /**
+     * Commands are parsed as they are queued. The few that need their
+     * text when they run keep it in a separate ring of text lines.
+     */
+    static parsed_command_t command_buffer[BUFSIZE];
+    static char text_buffer[PREPARSED_TEXT_LINES][MAX_CMD_SIZE];
+    static uint8_t text_length; // Count of text lines in use
+
+    // Room for one more command, whether or not it keeps its text
+    static inline bool has_space() { return length < BUFSIZE && text_length < PREPARSED_TEXT_LINES; }
+  #else
+    static char command_buffer[BUFSIZE][MAX_CMD_SIZE];
+
+    static inline bool has_space() { return length < BUFSIZE; }
+  #endif
 
   /*
    * The port that the command was received on
@@ -117,12 +136,62 @@ public:
    * Clear the serial line and request a resend of
    * the next expected line number.
    */
-  static void flush_and_request_resend();
+  static void flush_and_request_resend(const int8_t p);
+
+  #if ENABLED(SERIAL_CREDIT_FLOW)
+    /**
+     * Credit-based flow control (M577)
+     * Instead of one "ok" per command, the host is sent "ok C<n>" to return
+     * n queue slots at a time and keeps sending while it has credit left.
+     */
+    static bool credit_flow[NUM_SERIAL];  // Port is in credit mode
+    static uint8_t credit_batch;          // Credits to collect before returning them
+
+    static void set_credit_flow(const int8_t p, const bool on);
+  #endif
+
+  #if ENABLED(SERIAL_PORT_SCHEDULER)
+    /**
+     * Serial ports take turns to queue lines. The port that sent the
+     * latest move owns the print and gets 'print_weight' turns to each
+     * one of the other port, which may only have OTHER_PORT_QUEUE
+     * commands in the queue.
+     */
+    struct port_stats_t {
+      uint32_t lines,   // Lines queued
+               bytes,   // Bytes read
+               held;    // Reads where the port had data but had to wait
+      uint8_t queued;   // Commands in the queue now
+    };
+    static port_stats_t port_stats[NUM_SERIAL];
+    static int8_t print_port;       // Port that sent the latest move, or -1
+    static uint8_t print_weight;    // Lines from the print port per line from the other
+  #endif
+
+  #if ENABLED(BINARY_GCODE_STREAMING)
+    /**
+     * Queue a command decoded from a binary stream packet.
+     * The packet is acknowledged instead of each command.
+     */
+    static inline bool enqueue_decoded(const char* cmd, const int8_t p) {
+      #if NUM_SERIAL > 1
+        return _enqueue(cmd, false, p);
+      #else
+        UNUSED(p);
+        return _enqueue(cmd);
+      #endif
+    }
+  #endif
 
 private:
 
   static uint8_t index_w;  // Ring buffer write position
 
+  #if ENABLED(PREPARSED_COMMAND_QUEUE)
+    static uint8_t text_index_w;  // Text line ring write position
+    static bool store_command(const char* cmd);
+  #endif
+
   static void get_serial_commands();
 
   #if ENABLED(SDSUPPORT)
@@ -152,6 +221,38 @@ private:
 
   static void gcode_line_error(PGM_P const err, const int8_t port);
 
+  #if ENABLED(SERIAL_CREDIT_FLOW)
+    static uint8_t credits[NUM_SERIAL];   // Credits collected for each port
+    static void return_credits(const int8_t p);
+    static void release_credit(const uint8_t i);
+  #endif
+
+  #if ENABLED(SERIAL_PORT_SCHEDULER)
+    static uint8_t turns[NUM_SERIAL];     // Lines each port may still queue this round
+    static bool port_ready(const uint8_t p);
+    static void port_line_queued(const uint8_t p, const char *cmd);
+  #endif
+
+  #if ENABLED(SERIAL_SELECTIVE_RESEND)
+    /**
+     * Good lines received after a gap in the line numbers,
+     * held until the lines before them have been resent.
+     */
+    struct held_line_t {
+      long N;
+      int8_t port;
+      char line[MAX_CMD_SIZE];
+    };
+    static held_line_t held[RESEND_BUFFER_LINES];
+    static uint8_t held_count;
+    static long resend_N;                 // Last line number asked for with "Resend:"
+
+    static bool hold_line(const char* cmd, const long N, const int8_t p);
+    static void release_held_lines();
+    static void request_resend(const int8_t p);
+    static void skip_line(const int8_t p);
+  #endif
+
 };
 
 extern GCodeQueue queue;
@@ -22,21 +22,30 @@
 
 #include "../../inc/MarlinConfig.h"
 
-#if ENABLED(SDSUPPORT)
+#if EITHER(SDSUPPORT, BINARY_GCODE_STREAMING)
 
 #include "../gcode.h"
-#include "../../sd/cardreader.h"
 
-#if NUM_SERIAL > 1
-  #include "../queue.h"
+#if ENABLED(SDSUPPORT)
+  #include "../../sd/cardreader.h"
+#endif
+
+#if HAS_BINARY_STREAM
+  #include "../../feature/binary_protocol.h"
+  #if NUM_SERIAL > 1
+    #include "../queue.h"
+  #endif
 #endif
 
 /**
  * M28: Start SD Write
+ *
+ * M28 B1 switches to the binary stream protocol
+ * (BINARY_FILE_TRANSFER / BINARY_GCODE_STREAMING)
  */
 void GcodeSuite::M28() {
 
-  #if ENABLED(BINARY_FILE_TRANSFER)
+  #if HAS_BINARY_STREAM
 
     bool binary_mode = false;
     char *p = parser.string_arg;
@@ -47,14 +56,17 @@ void GcodeSuite::M28() {
     }
 
     // Binary transfer mode
-    if ((card.flag.binary_mode = binary_mode)) {
+    if ((BinaryStream::active = binary_mode)) {
       SERIAL_ECHO_MSG("Switching to Binary Protocol");
       #if NUM_SERIAL > 1
-        card.transfer_port_index = queue.port[queue.index_r];
+        BinaryStream::port = queue.port[queue.index_r];
+      #endif
+    }
+    else {
+      #if ENABLED(SDSUPPORT)
+        card.openFile(p, false);
       #endif
     }
-    else
-      card.openFile(p, false);
 
   #else
 
@@ -63,12 +75,16 @@ void GcodeSuite::M28() {
   #endif
 }
 
-/**
- * M29: Stop SD Write
- * (Processed in write-to-file routine)
- */
-void GcodeSuite::M29() {
-  card.flag.saving = false;
-}
+#if ENABLED(SDSUPPORT)
+
+  /**
+   * M29: Stop SD Write
+   * (Processed in write-to-file routine)
+   */
+  void GcodeSuite::M29() {
+    card.flag.saving = false;
+  }
+
+#endif
 
-#endif // SDSUPPORT
+#endif // SDSUPPORT || BINARY_GCODE_STREAMING
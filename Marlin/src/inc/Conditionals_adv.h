@@ -39,6 +39,7 @@
   #undef AUTOTEMP
   #undef PID_EXTRUSION_SCALING
   #undef LIN_ADVANCE
+  #undef SMOOTH_LIN_ADVANCE
   #undef FILAMENT_RUNOUT_SENSOR
   #undef ADVANCED_PAUSE_FEATURE
   #undef FILAMENT_RUNOUT_DISTANCE_MM
@@ -56,6 +57,12 @@
 
 #define HAS_CUTTER EITHER(SPINDLE_FEATURE, LASER_FEATURE)
 
+// Linear Advance steps the extruder from its own ISR, unless the advance is planned per block
+#define HAS_ADVANCE_ISR (ENABLED(LIN_ADVANCE) && DISABLED(SMOOTH_LIN_ADVANCE))
+
+// The binary stream protocol carries file transfers and / or G-code
+#define HAS_BINARY_STREAM EITHER(BINARY_FILE_TRANSFER, BINARY_GCODE_STREAMING)
+
 #if !defined(__AVR__) || !defined(USBCON)
   // Define constants and variables for buffering serial data.
   // Use only 0 or powers of 2 greater than 1
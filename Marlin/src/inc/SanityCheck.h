@@ -893,6 +893,16 @@ static_assert(Y_MAX_LENGTH >= Y_BED_SIZE, "Movement bounds (Y_MIN_POS, Y_MAX_POS
     WITHIN(LIN_ADVANCE_K, 0, 10),
     "LIN_ADVANCE_K must be a value from 0 to 10 (Changed in LIN_ADVANCE v1.5, Marlin 1.1.9)."
   );
+  #if ENABLED(SMOOTH_LIN_ADVANCE)
+    #if ENABLED(MIXING_EXTRUDER)
+      #error "SMOOTH_LIN_ADVANCE is not compatible with MIXING_EXTRUDER."
+    #elif ENABLED(I2S_STEPPER_STREAM)
+      #error "SMOOTH_LIN_ADVANCE is not compatible with I2S_STEPPER_STREAM."
+    #elif !defined(LIN_ADVANCE_SMOOTH_TIME)
+      #error "SMOOTH_LIN_ADVANCE requires LIN_ADVANCE_SMOOTH_TIME."
+    #endif
+    static_assert(WITHIN(LIN_ADVANCE_SMOOTH_TIME, 0, 0.2), "LIN_ADVANCE_SMOOTH_TIME must be a value from 0 to 0.2.");
+  #endif
 #endif
 
 /**
@@ -2318,6 +2328,8 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
 
 #if !BLOCK_BUFFER_SIZE || !IS_POWER_OF_2(BLOCK_BUFFER_SIZE)
   #error "BLOCK_BUFFER_SIZE must be a power of 2."
+#elif BLOCK_BUFFER_SIZE > 256 && !defined(CPU_32_BIT)
+  #error "BLOCK_BUFFER_SIZE over 256 requires a 32-bit board."
 #endif
 
 #if ENABLED(LED_CONTROL_MENU) && DISABLED(ULTIPANEL)
@@ -2564,3 +2576,114 @@ static_assert(   _ARR_TEST(3,0) && _ARR_TEST(3,1) && _ARR_TEST(3,2)
     #error "LIN_ADVANCE with TMC driver on extruder requires SQUARE_WAVE_STEPPING or MINIMUM_STEPPER_PULSE >= 1"
   #endif
 #endif
+
+#if ENABLED(SEGMENT_COALESCING)
+  #if IS_KINEMATIC
+    #error "SEGMENT_COALESCING is only compatible with Cartesian and Core machines."
+  #elif COALESCE_MAX_SEGMENTS < 2
+    #error "COALESCE_MAX_SEGMENTS must be 2 or more."
+  #endif
+#endif
+
+#if ENABLED(ADAPTIVE_MULTI_STEPPING)
+  #ifndef CPU_32_BIT
+    #error "ADAPTIVE_MULTI_STEPPING requires a 32-bit board."
+  #elif ENABLED(DISABLE_MULTI_STEPPING)
+    #error "ADAPTIVE_MULTI_STEPPING is incompatible with DISABLE_MULTI_STEPPING."
+  #elif !WITHIN(MULTI_STEPPING_ISR_LOAD, 10, 95)
+    #error "MULTI_STEPPING_ISR_LOAD must be between 10 and 95."
+  #endif
+#endif
+
+#if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+  #if ENABLED(S_CURVE_ACCELERATION)
+    #error "PRECOMPUTED_STEP_SCHEDULE is incompatible with S_CURVE_ACCELERATION."
+  #elif ENABLED(ADAPTIVE_STEP_SMOOTHING)
+    #error "PRECOMPUTED_STEP_SCHEDULE is incompatible with ADAPTIVE_STEP_SMOOTHING."
+  #elif !WITHIN(STEP_SCHEDULE_SIZE, 1, 255)
+    #error "STEP_SCHEDULE_SIZE must be between 1 and 255."
+  #endif
+#endif
+
+#if ENABLED(INPUT_SHAPING)
+  #if IS_KINEMATIC || IS_CORE
+    #error "INPUT_SHAPING is only compatible with Cartesian machines."
+  #elif ENABLED(I2S_STEPPER_STREAM)
+    #error "INPUT_SHAPING is incompatible with I2S_STEPPER_STREAM."
+  #elif SHAPING_BUFFER_SIZE < 256 || (SHAPING_BUFFER_SIZE & (SHAPING_BUFFER_SIZE - 1))
+    #error "SHAPING_BUFFER_SIZE must be a power of 2, 256 or more."
+  #elif SHAPING_BUFFER_SIZE > 32768
+    #error "SHAPING_BUFFER_SIZE must be 32768 or less."
+  #endif
+  static_assert(WITHIN(SHAPING_DAMPING_X, 0, 0.99) && WITHIN(SHAPING_DAMPING_Y, 0, 0.99),
+    "SHAPING_DAMPING_[XY] must be between 0 and 0.99.");
+#endif
+
+/**
+ * Pre-parsed command queue
+ */
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "PREPARSED_COMMAND_QUEUE requires FASTER_GCODE_PARSER."
+  #elif !WITHIN(PREPARSED_MAX_VALUES, 1, 8)
+    #error "PREPARSED_MAX_VALUES must be from 1 to 8."
+  #elif !WITHIN(PREPARSED_TEXT_LINES, 1, BUFSIZE)
+    #error "PREPARSED_TEXT_LINES must be from 1 to BUFSIZE."
+  #endif
+#endif
+
+/**
+ * Credit-based flow control
+ */
+#if ENABLED(SERIAL_CREDIT_FLOW) && !WITHIN(CREDIT_FLOW_BATCH, 1, BUFSIZE)
+  #error "CREDIT_FLOW_BATCH must be from 1 to BUFSIZE."
+#endif
+
+/**
+ * Scanned ADC sampling
+ */
+#if ENABLED(ADC_SCAN_SAMPLING)
+  #ifndef HAL_ADC_SCAN
+    #error "ADC_SCAN_SAMPLING requires a HAL that converts all ADC channels continuously (LPC176x, SAMD51, Linux)."
+  #elif !WITHIN(ADC_SCAN_INTERVAL, 1, 255)
+    #error "ADC_SCAN_INTERVAL must be from 1 to 255."
+  #endif
+#endif
+
+/**
+ * Direct-indexed thermistor tables
+ */
+#if ENABLED(THERMISTOR_DIRECT_TABLES) && !WITHIN(THERMISTOR_DIRECT_BITS, 4, 10)
+  #error "THERMISTOR_DIRECT_BITS must be from 4 to 10."
+#endif
+
+/**
+ * Selective resend
+ */
+#if ENABLED(SERIAL_SELECTIVE_RESEND) && !WITHIN(RESEND_BUFFER_LINES, 1, 16)
+  #error "RESEND_BUFFER_LINES must be from 1 to 16."
+#endif
+
+/**
+ * Serial port scheduler
+ */
+#if ENABLED(SERIAL_PORT_SCHEDULER)
+  #if NUM_SERIAL < 2
+    #error "SERIAL_PORT_SCHEDULER requires SERIAL_PORT_2."
+  #elif !WITHIN(PRINT_PORT_WEIGHT, 1, 255)
+    #error "PRINT_PORT_WEIGHT must be from 1 to 255."
+  #elif !WITHIN(OTHER_PORT_QUEUE, 1, BUFSIZE)
+    #error "OTHER_PORT_QUEUE must be from 1 to BUFSIZE."
+  #endif
+#endif
+
+/**
+ * DMA serial receive
+ */
+#if ENABLED(SERIAL_DMA) && !defined(TARGET_LPC1768)
+  #error "SERIAL_DMA is only available for LPC176x boards."
+#endif
+
+#if ENABLED(MOTION_BENCHMARK) && !defined(__PLAT_LINUX__)
+  #error "MOTION_BENCHMARK requires a Linux native build."
+#endif
@@ -37,7 +37,7 @@
  */
 
 // Change EEPROM version if the structure changes
-#define EEPROM_VERSION "V74"
+#define EEPROM_VERSION "V76"
 #define EEPROM_OFFSET 100
 
 // Check the integrity of data offsets.
@@ -291,6 +291,9 @@ typedef struct SettingsDataStruct {
   // LIN_ADVANCE
   //
   float planner_extruder_advance_K[EXTRUDERS];          // M900 K  planner.extruder_advance_K
+  #if ENABLED(SMOOTH_LIN_ADVANCE)
+    float planner_advance_smooth_time;                  // M900 W  planner.advance_smooth_time
+  #endif
 
   //
   // HAS_MOTOR_CURRENT_PWM
@@ -328,6 +331,13 @@ typedef struct SettingsDataStruct {
   uint8_t backlash_correction;                          // M425 F
   float backlash_smoothing_mm;                          // M425 S
 
+  //
+  // INPUT_SHAPING
+  //
+  #if ENABLED(INPUT_SHAPING)
+    shaper_settings_t shaper_settings[2];               // M593 X Y F D T
+  #endif
+
   //
   // EXTENSIBLE_UI
   //
@@ -393,6 +403,11 @@ void MarlinSettings::postprocess() {
     stepper.refresh_motor_power();
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    stepper.update_shaper(X_AXIS);
+    stepper.update_shaper(Y_AXIS);
+  #endif
+
   #if ENABLED(FWRETRACT)
     fwretract.refresh_autoretract();
   #endif
@@ -1140,6 +1155,11 @@ void MarlinSettings::postprocess() {
         dummy = 0;
         for (uint8_t q = EXTRUDERS; q--;) EEPROM_WRITE(dummy);
       #endif
+
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        _FIELD_TEST(planner_advance_smooth_time);
+        EEPROM_WRITE(planner.advance_smooth_time);
+      #endif
     }
 
     //
@@ -1219,6 +1239,14 @@ void MarlinSettings::postprocess() {
       EEPROM_WRITE(backlash_smoothing_mm);
     }
 
+    //
+    // Input Shaping
+    //
+    #if ENABLED(INPUT_SHAPING)
+      _FIELD_TEST(shaper_settings);
+      EEPROM_WRITE(stepper.shaper_settings);
+    #endif
+
     //
     // Extensible UI User Data
     //
@@ -1642,6 +1670,9 @@ void MarlinSettings::postprocess() {
       {
         _FIELD_TEST(user_thermistor);
         EEPROM_READ(thermalManager.user_thermistor);
+        #if ENABLED(THERMISTOR_DIRECT_TABLES)
+          if (!validating) LOOP_L_N(i, USER_THERMISTORS) thermalManager.user_thermistor[i].pre_calc = true;
+        #endif
       }
       #endif
 
@@ -1934,6 +1965,13 @@ void MarlinSettings::postprocess() {
           if (!validating)
             COPY(planner.extruder_advance_K, extruder_advance_K);
         #endif
+
+        #if ENABLED(SMOOTH_LIN_ADVANCE)
+          float advance_smooth_time;
+          _FIELD_TEST(planner_advance_smooth_time);
+          EEPROM_READ(advance_smooth_time);
+          if (!validating) planner.advance_smooth_time = advance_smooth_time;
+        #endif
       }
 
       //
@@ -2024,6 +2062,14 @@ void MarlinSettings::postprocess() {
         EEPROM_READ(backlash_smoothing_mm);
       }
 
+      //
+      // Input Shaping
+      //
+      #if ENABLED(INPUT_SHAPING)
+        _FIELD_TEST(shaper_settings);
+        EEPROM_READ(stepper.shaper_settings);
+      #endif
+
       //
       // Extensible UI User Data
       //
@@ -2320,6 +2366,11 @@ void MarlinSettings::reset() {
     #endif
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    stepper.shaper_settings[X_AXIS] = { SHAPING_FREQ_X, SHAPING_DAMPING_X, SHAPING_TYPE_X };
+    stepper.shaper_settings[Y_AXIS] = { SHAPING_FREQ_Y, SHAPING_DAMPING_Y, SHAPING_TYPE_Y };
+  #endif
+
   #if ENABLED(EXTENSIBLE_UI)
     ExtUI::onFactoryReset();
   #endif
@@ -2546,6 +2597,9 @@ void MarlinSettings::reset() {
       saved_extruder_advance_K[i] = LIN_ADVANCE_K;
     #endif
     }
+    #if ENABLED(SMOOTH_LIN_ADVANCE)
+      planner.advance_smooth_time = LIN_ADVANCE_SMOOTH_TIME;
+    #endif
   #endif
 
   //
@@ -3381,6 +3435,10 @@ void MarlinSettings::reset() {
         LOOP_L_N(i, EXTRUDERS)
           SERIAL_ECHOLNPAIR("  M900 T", int(i), " K", planner.extruder_advance_K[i]);
       #endif
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        CONFIG_ECHO_START();
+        SERIAL_ECHOLNPAIR("  M900 W", planner.advance_smooth_time);
+      #endif
     #endif
 
     #if HAS_MOTOR_CURRENT_PWM
@@ -3440,6 +3498,15 @@ void MarlinSettings::reset() {
       );
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      CONFIG_ECHO_HEADING("Input Shaping:");
+      LOOP_L_N(a, 2) {
+        const shaper_settings_t &ss = stepper.shaper_settings[a];
+        CONFIG_ECHO_START();
+        SERIAL_ECHOLNPAIR("  M593 ", axis_codes[a], " F", ss.frequency, " D", ss.damping, " T", int(ss.type));
+      }
+    #endif
+
     #if HAS_FILAMENT_SENSOR
       CONFIG_ECHO_HEADING("Filament runout sensor:");
       CONFIG_ECHO_START();
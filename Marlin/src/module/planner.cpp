@@ -108,6 +108,10 @@
   #include "../feature/spindle_laser.h"
 #endif
 
+#if ENABLED(MOTION_BENCHMARK)
+  #include "../feature/benchmark.h"
+#endif
+
 // Delay for delivery of first block to the stepper ISR, if the queue contains 2 or
 // fewer movements. The delay is measured in milliseconds, and must be less than 250ms
 #define BLOCK_DELAY_FOR_1ST_MOVE 100
@@ -119,11 +123,15 @@ Planner planner;
 /**
  * A ring buffer of moves described in steps
  */
-block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
-volatile uint8_t Planner::block_buffer_head,    // Index of the next block to be pushed
-                 Planner::block_buffer_nonbusy, // Index of the first non-busy block
-                 Planner::block_buffer_planned, // Index of the optimally planned block
-                 Planner::block_buffer_tail;    // Index of the busy block, if any
+#ifdef BLOCK_BUFFER_SECTION
+  block_t Planner::block_buffer[BLOCK_BUFFER_SIZE] __attribute__((section(BLOCK_BUFFER_SECTION)));
+#else
+  block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
+#endif
+volatile block_index_t Planner::block_buffer_head,    // Index of the next block to be pushed
+                       Planner::block_buffer_nonbusy, // Index of the first non-busy block
+                       Planner::block_buffer_planned, // Index of the optimally planned block
+                       Planner::block_buffer_tail;    // Index of the busy block, if any
 uint16_t Planner::cleaning_buffer_counter;      // A counter to disable queuing of blocks
 uint8_t Planner::delay_before_delivering;       // This counter delays delivery of blocks when queue becomes empty to allow the opportunity of merging blocks
 
@@ -203,7 +211,11 @@ xyze_float_t Planner::previous_speed;
 float Planner::previous_nominal_speed_sqr;
 
 #if ENABLED(DISABLE_INACTIVE_EXTRUDER)
-  uint8_t Planner::g_uc_extruder_last_move[EXTRUDERS] = { 0 };
+  uint16_t Planner::g_uc_extruder_last_move[EXTRUDERS] = { 0 };
+#endif
+
+#if ENABLED(SEGMENT_COALESCING)
+  coalesce_t Planner::coalesce;
 #endif
 
 #ifdef XY_FREQUENCY_LIMIT
@@ -215,6 +227,9 @@ float Planner::previous_nominal_speed_sqr;
 
 #if ENABLED(LIN_ADVANCE)
   float Planner::extruder_advance_K[EXTRUDERS]; // Initialized by settings.load()
+  #if ENABLED(SMOOTH_LIN_ADVANCE)
+    float Planner::advance_smooth_time;         // Initialized by settings.load()
+  #endif
 #endif
 
 #if HAS_POSITION_FLOAT
@@ -720,6 +735,126 @@ void Planner::init() {
  * alter its values.
  */
 void Planner::calculate_trapezoid_for_block(block_t* const block, const float &entry_factor, const float &exit_factor) {
+  #if ENABLED(PLANNER_FIXED_POINT)
+    calculate_trapezoid_fixed(block, uint32_t(entry_factor * 65536.0f), uint32_t(exit_factor * 65536.0f));
+    #if ENABLED(MOTION_BENCHMARK)
+      // Check the result against the float version
+      block_t ref = *block;
+      calculate_trapezoid_float(&ref, entry_factor, exit_factor);
+      benchmark.compare_trapezoid(*block, ref);
+    #endif
+  #else
+    calculate_trapezoid_float(block, entry_factor, exit_factor);
+  #endif
+}
+
+#if ENABLED(PLANNER_FIXED_POINT)
+
+  // (a² - b²) for step rates, which overflows 32 bits above 65535 steps/s
+  FORCE_INLINE static uint64_t rate_sq_diff(const uint32_t a, const uint32_t b) { return uint64_t(a - b) * (a + b); }
+
+  // Divide, rounding up or down, sticking to 32-bit division whenever possible
+  static uint32_t div_ceil(const uint64_t n, const uint32_t d) {
+    if (!n || !d) return 0;
+    return (n >> 32) ? uint32_t((n - 1) / d + 1) : (uint32_t(n) - 1) / d + 1;
+  }
+  static uint32_t div_floor(const uint64_t n, const uint32_t d) {
+    if (!d) return 0;
+    return (n >> 32) ? uint32_t(n / d) : uint32_t(n) / d;
+  }
+
+  #if ENABLED(S_CURVE_ACCELERATION)
+    // Integer square root, rounded down
+    static uint32_t isqrt(uint64_t n) {
+      uint64_t r = 0, b = 1ULL << 62;
+      while (b > n) b >>= 2;
+      while (b) {
+        if (n >= r + b) { n -= r + b; r = (r >> 1) + b; }
+        else r >>= 1;
+        b >>= 2;
+      }
+      return uint32_t(r);
+    }
+  #endif
+
+  /**
+   * Integer version of calculate_trapezoid_float() for MCUs without an FPU.
+   * The entry and exit factors are Q16.16 fractions of the nominal rate.
+   * Rates are rounded up and step counts follow the float rounding, so the
+   * block_t fields match the float version to within a step or so.
+   */
+  void Planner::calculate_trapezoid_fixed(block_t* const block, const uint32_t entry_factor, const uint32_t exit_factor) {
+
+    const uint32_t nominal_rate = block->nominal_rate;
+    uint32_t initial_rate = (uint64_t(nominal_rate) * entry_factor + 0xFFFF) >> 16,
+             final_rate = (uint64_t(nominal_rate) * exit_factor + 0xFFFF) >> 16; // (steps per second)
+
+    // Limit minimal step rate (Otherwise the timer will overflow.)
+    NOLESS(initial_rate, uint32_t(MINIMAL_STEP_RATE));
+    NOLESS(final_rate, uint32_t(MINIMAL_STEP_RATE));
+
+    #if ENABLED(S_CURVE_ACCELERATION)
+      uint32_t cruise_rate = initial_rate;
+    #endif
+
+    const uint32_t accel = block->acceleration_steps_per_s2,
+                   step_event_count = block->step_event_count;
+
+            // Steps required for acceleration, deceleration to/from nominal rate
+    uint32_t accelerate_steps = nominal_rate > initial_rate ? div_ceil(rate_sq_diff(nominal_rate, initial_rate), accel << 1) : 0,
+             decelerate_steps = nominal_rate > final_rate ? div_floor(rate_sq_diff(nominal_rate, final_rate), accel << 1) : 0;
+            // Steps between acceleration and deceleration, if any
+    int32_t plateau_steps = step_event_count - accelerate_steps - decelerate_steps;
+
+    // Does accelerate_steps + decelerate_steps exceed step_event_count?
+    // Then we can't possibly reach the nominal rate, there will be no cruising.
+    // Find the intersection of the accel / decel ramps instead:
+    //  (2 * accel * distance - initial_rate² + final_rate²) / (4 * accel)
+    if (plateau_steps < 0) {
+      const int64_t n = int64_t(accel) * (step_event_count << 1) + int64_t(final_rate) * final_rate - int64_t(initial_rate) * initial_rate;
+      accelerate_steps = n > 0 ? _MIN(div_ceil(n, accel << 2), step_event_count) : 0;
+      plateau_steps = 0;
+
+      #if ENABLED(S_CURVE_ACCELERATION)
+        // We won't reach the cruising rate. Let's calculate the speed we will reach
+        cruise_rate = isqrt(uint64_t(initial_rate) * initial_rate + uint64_t(accel) * (accelerate_steps << 1));
+      #endif
+    }
+    #if ENABLED(S_CURVE_ACCELERATION)
+      else // We have some plateau time, so the cruise rate will be the nominal rate
+        cruise_rate = nominal_rate;
+    #endif
+
+    #if ENABLED(S_CURVE_ACCELERATION)
+      // Jerk controlled speed requires to express speed versus time, NOT steps
+      uint32_t acceleration_time = accel ? uint64_t(cruise_rate - initial_rate) * (STEPPER_TIMER_RATE) / accel : 0,
+               deceleration_time = accel && cruise_rate > final_rate ? uint64_t(cruise_rate - final_rate) * (STEPPER_TIMER_RATE) / accel : 0;
+
+      // And to offload calculations from the ISR, we also calculate the inverse of those times here
+      uint32_t acceleration_time_inverse = get_period_inverse(acceleration_time);
+      uint32_t deceleration_time_inverse = get_period_inverse(deceleration_time);
+    #endif
+
+    // Store new block parameters
+    block->accelerate_until = accelerate_steps;
+    block->decelerate_after = accelerate_steps + plateau_steps;
+    block->initial_rate = initial_rate;
+    #if ENABLED(S_CURVE_ACCELERATION)
+      block->acceleration_time = acceleration_time;
+      block->deceleration_time = deceleration_time;
+      block->acceleration_time_inverse = acceleration_time_inverse;
+      block->deceleration_time_inverse = deceleration_time_inverse;
+      block->cruise_rate = cruise_rate;
+    #endif
+    block->final_rate = final_rate;
+  }
+
+#endif // PLANNER_FIXED_POINT
+
+#if DISABLED(PLANNER_FIXED_POINT) || ENABLED(MOTION_BENCHMARK)
+
+// Floating point trapezoid calculation (the reference for the fixed-point version)
+void Planner::calculate_trapezoid_float(block_t* const block, const float &entry_factor, const float &exit_factor) {
 
   uint32_t initial_rate = CEIL(block->nominal_rate * entry_factor),
            final_rate = CEIL(block->nominal_rate * exit_factor); // (steps per second)
@@ -783,6 +918,42 @@ void Planner::calculate_trapezoid_for_block(block_t* const block, const float &e
   block->final_rate = final_rate;
 }
 
+#endif // !PLANNER_FIXED_POINT || MOTION_BENCHMARK
+
+#if ENABLED(SMOOTH_LIN_ADVANCE)
+
+  /**
+   * The stepper moves the pressure to the advance for the end of each trapezoid
+   * phase within the phase, so the advance to accelerate to is the one for the
+   * speed actually reached. The change isn't made at once but spread over
+   * advance_smooth_time, as a moving average would: each phase makes a share of
+   * the change still to do, its duration over the smoothing time, or all of it
+   * for a phase longer than that.
+   */
+  void Planner::calculate_smooth_advance(block_t* const block) {
+    const float accel = block->acceleration_steps_per_s2,
+                peak_rate = _MIN(float(block->nominal_rate), SQRT(sq(float(block->initial_rate)) + 2 * accel * block->accelerate_until));
+
+    block->max_adv_steps = block->max_adv_steps * peak_rate / block->nominal_rate;
+
+    if (advance_smooth_time <= 0) {
+      LOOP_L_N(i, COUNT(block->adv_smoothing)) block->adv_smoothing[i] = 256;
+      return;
+    }
+
+    const float phase_time[3] = {
+      (peak_rate - block->initial_rate) / accel,
+      (block->decelerate_after - block->accelerate_until) / peak_rate,
+      (peak_rate - block->final_rate) / accel
+    };
+    LOOP_L_N(i, COUNT(block->adv_smoothing))
+      block->adv_smoothing[i] = phase_time[i] <= 0 ? 0
+                              : phase_time[i] < advance_smooth_time ? uint16_t(256 * phase_time[i] / advance_smooth_time)
+                              : 256;
+  }
+
+#endif
+
 /*                            PLANNER SPEED DEFINITION
                                      +--------+   <- current->nominal_speed
                                     /          \
@@ -823,6 +994,11 @@ void Planner::calculate_trapezoid_for_block(block_t* const block, const float &e
   used feed holds or feedrate overrides, the stop-compute pointers will be reset and the entire plan is
   recomputed as stated in the general guidelines.
 
+  The reverse pass also stops as soon as it meets a block whose entry speed it didn't change. All
+  junctions before that block are constrained exactly as they were in the previous (optimal) plan, so the
+  forward pass and the trapezoid recalculation only need to start from there. With dense streams of short
+  segments this keeps the work per new block close to constant instead of proportional to the buffer depth.
+
   Planner buffer index mapping:
   - block_buffer_tail: Points to the beginning of the planner buffer. First to be executed or being executed.
   - block_buffer_head: Points to the buffer block after the last block in the buffer. Used to indicate whether
@@ -896,19 +1072,20 @@ void Planner::reverse_pass_kernel(block_t* const current, const block_t * const
 /**
  * recalculate() needs to go over the current plan twice.
  * Once in reverse and once forward. This implements the reverse pass.
+ * Returns the index of the oldest block the passes need to look at.
  */
-void Planner::reverse_pass() {
+block_index_t Planner::reverse_pass() {
   // Initialize block index to the last block in the planner buffer.
-  uint8_t block_index = prev_block_index(block_buffer_head);
+  block_index_t block_index = prev_block_index(block_buffer_head);
 
   // Read the index of the last buffer planned block.
   // The ISR may change it so get a stable local copy.
-  uint8_t planned_block_index = block_buffer_planned;
+  block_index_t planned_block_index = block_buffer_planned;
 
   // If there was a race condition and block_buffer_planned was incremented
   //  or was pointing at the head (queue empty) break loop now and avoid
   //  planning already consumed blocks
-  if (planned_block_index == block_buffer_head) return;
+  if (planned_block_index == block_buffer_head) return planned_block_index;
 
   // Reverse Pass: Coarsely maximize all possible deceleration curves back-planning from the last
   // block in buffer. Cease planning when the last optimal planned or tail pointer is reached.
@@ -922,6 +1099,14 @@ void Planner::reverse_pass() {
     // Only consider non sync blocks
     if (!TEST(current->flag, BLOCK_BIT_SYNC_POSITION)) {
       reverse_pass_kernel(current, next);
+
+      #if ENABLED(MOTION_BENCHMARK)
+        benchmark.reverse_pass_blocks++;
+      #endif
+
+      // Entry speed unchanged? Then all earlier blocks keep their optimal plan.
+      if (!TEST(current->flag, BLOCK_BIT_RECALCULATE)) return block_index;
+
       next = current;
     }
 
@@ -934,16 +1119,18 @@ void Planner::reverse_pass() {
     while (planned_block_index != block_buffer_planned) {
 
       // If we reached the busy block or an already processed block, break the loop now
-      if (block_index == planned_block_index) return;
+      if (block_index == planned_block_index) return block_index;
 
       // Advance the pointer, following the busy block
       planned_block_index = next_block_index(planned_block_index);
     }
   }
+
+  return planned_block_index;
 }
 
 // The kernel called by recalculate() when scanning the plan from first to last entry.
-void Planner::forward_pass_kernel(const block_t* const previous, block_t* const current, const uint8_t block_index) {
+void Planner::forward_pass_kernel(const block_t* const previous, block_t* const current, const block_index_t block_index) {
   if (previous) {
     // If the previous block is an acceleration block, too short to complete the full speed
     // change, adjust the entry speed accordingly. Entry speeds have already been reset,
@@ -995,8 +1182,9 @@ void Planner::forward_pass_kernel(const block_t* const previous, block_t* const
 /**
  * recalculate() needs to go over the current plan twice.
  * Once in reverse and once forward. This implements the forward pass.
+ * Starts at 'first', as returned by reverse_pass(), if it's still queued.
  */
-void Planner::forward_pass() {
+void Planner::forward_pass(const block_index_t first) {
 
   // Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
   // Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
@@ -1005,7 +1193,11 @@ void Planner::forward_pass() {
   //  by the stepper ISR,  so read it ONCE. It it guaranteed that block_buffer_planned
   //  will never lead head, so the loop is safe to execute. Also note that the forward
   //  pass will never modify the values at the tail.
-  uint8_t block_index = block_buffer_planned;
+  block_index_t block_index = block_buffer_planned;
+
+  // Blocks before the first one touched by the reverse pass can't change
+  if (BLOCK_MOD(first - block_index) < BLOCK_MOD(block_buffer_head - block_index))
+    block_index = first;
 
   block_t *block;
   const block_t * previous = nullptr;
@@ -1021,8 +1213,12 @@ void Planner::forward_pass() {
       // the previous block became BUSY, so assume the current block's
       // entry speed can't be altered (since that would also require
       // updating the exit speed of the previous block).
-      if (!previous || !stepper.is_block_busy(previous))
+      if (!previous || !stepper.is_block_busy(previous)) {
         forward_pass_kernel(previous, block, block_index);
+        #if ENABLED(MOTION_BENCHMARK)
+          benchmark.forward_pass_blocks++;
+        #endif
+      }
       previous = block;
     }
     // Advance to the previous
@@ -1033,19 +1229,23 @@ void Planner::forward_pass() {
 /**
  * Recalculate the trapezoid speed profiles for all blocks in the plan
  * according to the entry_factor for each junction. Must be called by
- * recalculate() after updating the blocks.
+ * recalculate() after updating the blocks. Blocks before 'first' have
+ * unchanged junction speeds, so the scan starts there if still queued.
  */
-void Planner::recalculate_trapezoids() {
+void Planner::recalculate_trapezoids(const block_index_t first) {
   // The tail may be changed by the ISR so get a local copy.
-  uint8_t block_index = block_buffer_tail,
-          head_block_index = block_buffer_head;
+  block_index_t block_index = block_buffer_tail,
+                head_block_index = block_buffer_head;
+
+  if (BLOCK_MOD(first - block_index) < BLOCK_MOD(head_block_index - block_index))
+    block_index = first;
   // Since there could be a sync block in the head of the queue, and the
   // next loop must not recalculate the head block (as it needs to be
   // specially handled), scan backwards to the first non-SYNC block.
   while (head_block_index != block_index) {
 
     // Go back (head always point to the first free block)
-    const uint8_t prev_index = prev_block_index(head_block_index);
+    const block_index_t prev_index = prev_block_index(head_block_index);
 
     // Get the pointer to the block
     block_t *prev = &block_buffer[prev_index];
@@ -1068,6 +1268,10 @@ void Planner::recalculate_trapezoids() {
     if (!TEST(next->flag, BLOCK_BIT_SYNC_POSITION)) {
       next_entry_speed = SQRT(next->entry_speed_sqr);
 
+      #if ENABLED(MOTION_BENCHMARK)
+        benchmark.trapezoid_blocks++;
+      #endif
+
       if (block) {
         // Recalculate if current block entry or exit junction speed has changed.
         if (TEST(block->flag, BLOCK_BIT_RECALCULATE) || TEST(next->flag, BLOCK_BIT_RECALCULATE)) {
@@ -1092,6 +1296,9 @@ void Planner::recalculate_trapezoids() {
                 const float comp = block->e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
                 block->max_adv_steps = current_nominal_speed * comp;
                 block->final_adv_steps = next_entry_speed * comp;
+                #if ENABLED(SMOOTH_LIN_ADVANCE)
+                  calculate_smooth_advance(block);
+                #endif
               }
             #endif
           }
@@ -1131,6 +1338,9 @@ void Planner::recalculate_trapezoids() {
           const float comp = next->e_D_ratio * extruder_advance_K[active_extruder] * settings.axis_steps_per_mm[E_AXIS];
           next->max_adv_steps = next_nominal_speed * comp;
           next->final_adv_steps = (MINIMUM_PLANNER_SPEED) * comp;
+          #if ENABLED(SMOOTH_LIN_ADVANCE)
+            calculate_smooth_advance(next);
+          #endif
         }
       #endif
     }
@@ -1143,13 +1353,13 @@ void Planner::recalculate_trapezoids() {
 
 void Planner::recalculate() {
   // Initialize block index to the last block in the planner buffer.
-  const uint8_t block_index = prev_block_index(block_buffer_head);
+  block_index_t block_index = prev_block_index(block_buffer_head);
   // If there is just one block, no planning can be done. Avoid it!
   if (block_index != block_buffer_planned) {
-    reverse_pass();
-    forward_pass();
+    block_index = reverse_pass();
+    forward_pass(block_index);
   }
-  recalculate_trapezoids();
+  recalculate_trapezoids(block_index);
 }
 
 #if ENABLED(AUTOTEMP)
@@ -1161,7 +1371,7 @@ void Planner::recalculate() {
     if (thermalManager.degTargetHotend(0) + 2 < autotemp_min) return; // probably temperature set to zero.
 
     float high = 0.0;
-    for (uint8_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b)) {
+    for (block_index_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b)) {
       block_t* block = &block_buffer[b];
       if (block->steps.x || block->steps.y || block->steps.z) {
         const float se = (float)block->steps.e / block->step_event_count * SQRT(block->nominal_speed_sqr); // mm/sec;
@@ -1221,7 +1431,7 @@ void Planner::check_axes_activity() {
     #endif
 
     #if ANY(DISABLE_X, DISABLE_Y, DISABLE_Z, DISABLE_E)
-      for (uint8_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b)) {
+      for (block_index_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b)) {
         block_t *block = &block_buffer[b];
         LOOP_XYZE(i) if (block->steps[i]) axis_active[i] = true;
       }
@@ -1490,6 +1700,12 @@ void Planner::quick_stop() {
   // Drop all queue entries
   block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail;
 
+  #if ENABLED(SEGMENT_COALESCING)
+    // ...and the held-back move
+    coalesce.count = 0;
+    coalesce.linked = false;
+  #endif
+
   // Restart the block delay for the first movement - As the queue was
   // forced to empty, there's no risk the ISR will touch this.
   delay_before_delivering = BLOCK_DELAY_FOR_1ST_MOVE;
@@ -1558,12 +1774,24 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
  * Block until all buffered steps are executed / cleaned
  */
 void Planner::synchronize() {
+  #if ENABLED(SEGMENT_COALESCING)
+    flush_coalesced();
+  #endif
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.syncing = true;
+  #endif
   while (
     has_blocks_queued() || cleaning_buffer_counter
+    #if ENABLED(INPUT_SHAPING)
+      || stepper.shaping_busy()
+    #endif
     #if ENABLED(EXTERNAL_CLOSED_LOOP_CONTROLLER)
       || (READ(CLOSED_LOOP_ENABLE_PIN) && !READ(CLOSED_LOOP_MOVE_COMPLETE_PIN))
     #endif
   ) idle();
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.syncing = false;
+  #endif
 }
 
 /**
@@ -1593,9 +1821,13 @@ bool Planner::_buffer_steps(const xyze_long_t &target
   if (cleaning_buffer_counter) return false;
 
   // Wait for the next available block
-  uint8_t next_buffer_head;
+  block_index_t next_buffer_head;
   block_t * const block = get_next_free_block(next_buffer_head);
 
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.plan_start();
+  #endif
+
   // Fill the block with the specified movement
   if (!_populate_block(block, false, target
     #if HAS_POSITION_FLOAT
@@ -1627,6 +1859,10 @@ bool Planner::_buffer_steps(const xyze_long_t &target
   // Recalculate and optimize trapezoidal speed profiles
   recalculate();
 
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.plan_end();
+  #endif
+
   // Movement successfully queued!
   return true;
 }
@@ -1967,7 +2203,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   float inverse_secs = fr_mm_s * inverse_millimeters;
 
   // Get the number of non busy movements in queue (non busy means that they can be altered)
-  const uint8_t moves_queued = nonbusy_movesplanned();
+  const block_index_t moves_queued = nonbusy_movesplanned();
 
   // Slow down when the buffer starts to empty, rather than wait at the corner for a buffer refill
   #if EITHER(SLOWDOWN, ULTRA_LCD) || defined(XY_FREQUENCY_LIMIT)
@@ -2188,7 +2424,7 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
   #if DISABLED(S_CURVE_ACCELERATION)
     block->acceleration_rate = (uint32_t)(accel * (4096.0f * 4096.0f / (STEPPER_TIMER_RATE)));
   #endif
-  #if ENABLED(LIN_ADVANCE)
+  #if HAS_ADVANCE_ISR
     if (block->use_advance_lead) {
       block->advance_speed = (STEPPER_TIMER_RATE) / (extruder_advance_K[active_extruder] * block->e_D_ratio * block->acceleration * settings.axis_steps_per_mm[E_AXIS_N(extruder)]);
       #if ENABLED(LA_DEBUG)
@@ -2458,8 +2694,12 @@ bool Planner::_populate_block(block_t * const block, bool split_move,
  * Add a block to the buffer that just updates the position
  */
 void Planner::buffer_sync_block() {
+  #if ENABLED(SEGMENT_COALESCING)
+    flush_coalesced();
+  #endif
+
   // Wait for the next available block
-  uint8_t next_buffer_head;
+  block_index_t next_buffer_head;
   block_t * const block = get_next_free_block(next_buffer_head);
 
   // Clear block
@@ -2506,6 +2746,12 @@ bool Planner::buffer_segment(const float &a, const float &b, const float &c, con
   // If we are cleaning, do not accept queuing of movements
   if (cleaning_buffer_counter) return false;
 
+  #if ENABLED(SEGMENT_COALESCING)
+    // Queue the held-back move first. This move isn't known to the coalescer.
+    flush_coalesced();
+    coalesce.linked = false;
+  #endif
+
   // When changing extruders recalculate steps corresponding to the E position
   #if ENABLED(DISTINCT_E_FACTORS)
     if (last_extruder != extruder && settings.axis_steps_per_mm[E_AXIS_N(extruder)] != settings.axis_steps_per_mm[E_AXIS_N(last_extruder)]) {
@@ -2584,6 +2830,103 @@ bool Planner::buffer_segment(const float &a, const float &b, const float &c, con
   return true;
 } // buffer_segment()
 
+#if ENABLED(SEGMENT_COALESCING)
+
+  /**
+   * Return how far along the chord a dropped point lies,
+   * or -1 if it's further than COALESCE_TOLERANCE from it.
+   */
+  static float distance_along_chord(const float &x, const float &y, const float &z, const xyze_pos_t &start, const xyz_float_t &unit, const float &chord_mm) {
+    const xyz_float_t d = { x - start.x, y - start.y, z - start.z };
+    const float along = d.x * unit.x + d.y * unit.y + d.z * unit.z;
+    if (!WITHIN(along, 0, chord_mm)) return -1;
+    return (sq(d.x) + sq(d.y) + sq(d.z) - sq(along) <= sq(float(COALESCE_TOLERANCE))) ? along : -1;
+  }
+
+  /**
+   * Try to extend the held-back move to 'target'. The new chord from the start
+   * of the run must pass all the dropped points in order and within tolerance,
+   * and the new segment must extrude at the rate of the first one.
+   */
+  bool Planner::coalesce_append(const xyze_pos_t &target, const feedRate_t &fr_mm_s, const uint8_t extruder) {
+    if (coalesce.count >= COALESCE_MAX_SEGMENTS || fr_mm_s != coalesce.fr_mm_s || extruder != coalesce.extruder)
+      return false;
+
+    const xyz_float_t seg = { target.x - coalesce.end.x, target.y - coalesce.end.y, target.z - coalesce.end.z },
+                      chord = { target.x - coalesce.start.x, target.y - coalesce.start.y, target.z - coalesce.start.z };
+    const float seg_mm = seg.magnitude(), chord_mm = chord.magnitude();
+    if (seg_mm < 0.0001f || chord_mm > (COALESCE_MAX_LENGTH)) return false;
+
+    // Keep E per mm, both for this segment and over the shorter merged chord
+    const float e_limit = (COALESCE_E_TOLERANCE) * ABS(coalesce.e_per_mm);
+    if (ABS((target.e - coalesce.end.e) / seg_mm - coalesce.e_per_mm) > e_limit) return false;
+    if (ABS((target.e - coalesce.start.e) / chord_mm - coalesce.e_per_mm) > e_limit) return false;
+
+    const float inv_chord_mm = 1.0f / chord_mm;
+    const xyz_float_t unit = { chord.x * inv_chord_mm, chord.y * inv_chord_mm, chord.z * inv_chord_mm };
+    float last = 0;
+    for (uint8_t i = 0; i < coalesce.count - 1; i++) {
+      const xyz_pos_t &p = coalesce.point[i];
+      const float along = distance_along_chord(p.x, p.y, p.z, coalesce.start, unit, chord_mm);
+      if (along < last) return false;
+      last = along;
+    }
+    if (distance_along_chord(coalesce.end.x, coalesce.end.y, coalesce.end.z, coalesce.start, unit, chord_mm) < last) return false;
+
+    coalesce.point[coalesce.count - 1].set(coalesce.end.x, coalesce.end.y, coalesce.end.z);
+    coalesce.end = target;
+    coalesce.count++;
+
+    #if ENABLED(MOTION_BENCHMARK)
+      benchmark.segments_coalesced++;
+    #endif
+
+    return true;
+  }
+
+  /**
+   * Cartesian buffer_line sends moves through here. A short move is held back
+   * so that the collinear moves following it can be merged into one block.
+   * Moves of a known length, E-only moves, and moves not starting exactly at
+   * the end of the last coalesced move are queued as-is.
+   */
+  bool Planner::coalesce_segment(xyze_pos_t &target, const feedRate_t &fr_mm_s, const uint8_t extruder, const float &millimeters) {
+    if (cleaning_buffer_counter) return false;
+
+    if (coalesce.count) {
+      if (!millimeters && coalesce_append(target, fr_mm_s, extruder)) return true;
+      flush_coalesced();
+    }
+
+    if (coalesce.linked && !millimeters) {
+      const xyz_float_t seg = { target.x - coalesce.end.x, target.y - coalesce.end.y, target.z - coalesce.end.z };
+      const float seg_mm = seg.magnitude();
+      if (WITHIN(seg_mm, 0.0001f, COALESCE_MAX_LENGTH)) {
+        coalesce.start = coalesce.end;
+        coalesce.end = target;
+        coalesce.fr_mm_s = fr_mm_s;
+        coalesce.extruder = extruder;
+        coalesce.e_per_mm = (target.e - coalesce.start.e) / seg_mm;
+        coalesce.count = 1;
+        return true;
+      }
+    }
+
+    if (!buffer_segment(target, fr_mm_s, extruder, millimeters)) return false;
+    coalesce.end = target;
+    coalesce.linked = true;
+    return true;
+  }
+
+  void Planner::flush_coalesced() {
+    if (!coalesce.count) return;
+    coalesce.count = 0;
+    xyze_pos_t target = coalesce.end;
+    coalesce.linked = buffer_segment(target, coalesce.fr_mm_s, coalesce.extruder);
+  }
+
+#endif // SEGMENT_COALESCING
+
 /**
  * Add a new linear movement to the buffer.
  * The target is cartesian. It's translated to
@@ -2641,6 +2984,8 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
     }
     else
       return false;
+  #elif ENABLED(SEGMENT_COALESCING)
+    return coalesce_segment(machine, fr_mm_s, extruder, millimeters);
   #else
     return buffer_segment(machine, fr_mm_s, extruder, millimeters);
   #endif
@@ -2654,6 +2999,10 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
  */
 
 void Planner::set_machine_position_mm(const float &a, const float &b, const float &c, const float &e) {
+  #if ENABLED(SEGMENT_COALESCING)
+    flush_coalesced();
+    coalesce.linked = false;
+  #endif
   #if ENABLED(DISTINCT_E_FACTORS)
     last_extruder = active_extruder;
   #endif
@@ -2697,6 +3046,10 @@ void Planner::set_position_mm(const float &rx, const float &ry, const float &rz,
  * Setters for planner position (also setting stepper position).
  */
 void Planner::set_e_position_mm(const float &e) {
+  #if ENABLED(SEGMENT_COALESCING)
+    flush_coalesced();
+    coalesce.linked = false;
+  #endif
   const uint8_t axis_index = E_AXIS_N(active_extruder);
   #if ENABLED(DISTINCT_E_FACTORS)
     last_extruder = active_extruder;
@@ -138,8 +138,12 @@ typedef struct block_t {
   // Advance extrusion
   #if ENABLED(LIN_ADVANCE)
     bool use_advance_lead;
-    uint16_t advance_speed,                 // STEP timer value for extruder speed offset ISR
-             max_adv_steps,                 // max. advance steps to get cruising speed pressure (not always nominal_speed!)
+    #if ENABLED(SMOOTH_LIN_ADVANCE)
+      uint16_t adv_smoothing[3];            // Share of the pressure change made in the accel / cruise / decel phase (1/256)
+    #else
+      uint16_t advance_speed;               // STEP timer value for extruder speed offset ISR
+    #endif
+    uint16_t max_adv_steps,                 // max. advance steps to get cruising speed pressure (not always nominal_speed!)
              final_adv_steps;               // advance steps due to exit speed
     float e_D_ratio;
   #endif
@@ -175,6 +179,25 @@ typedef struct block_t {
 
 #define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_SIZE-1))
 
+// Ring buffer index. Buffers over 256 blocks (32-bit boards only) need 16-bit indices.
+#if BLOCK_BUFFER_SIZE > 256
+  typedef uint16_t block_index_t;
+#else
+  typedef uint8_t block_index_t;
+#endif
+
+#if ENABLED(SEGMENT_COALESCING)
+  typedef struct {
+    uint8_t count;                              // Segments in the held-back move (0 = none)
+    bool linked;                                // The planner position is exactly 'end'
+    uint8_t extruder;
+    feedRate_t fr_mm_s;
+    float e_per_mm;                             // E ratio of the first merged segment
+    xyze_pos_t start, end;                      // The held-back move
+    xyz_pos_t point[COALESCE_MAX_SEGMENTS - 1]; // Points dropped by merging
+  } coalesce_t;
+#endif
+
 typedef struct {
    uint32_t max_acceleration_mm_per_s2[XYZE_N], // (mm/s^2) M201 XYZE
             min_segment_time_us;                // (µs) M205 B
@@ -224,10 +247,10 @@ class Planner {
      *  Reader of tail is Stepper::isr(). Always consider tail busy / read-only
      */
     static block_t block_buffer[BLOCK_BUFFER_SIZE];
-    static volatile uint8_t block_buffer_head,      // Index of the next block to be pushed
-                            block_buffer_nonbusy,   // Index of the first non busy block
-                            block_buffer_planned,   // Index of the optimally planned block
-                            block_buffer_tail;      // Index of the busy block, if any
+    static volatile block_index_t block_buffer_head,    // Index of the next block to be pushed
+                                  block_buffer_nonbusy, // Index of the first non busy block
+                                  block_buffer_planned, // Index of the optimally planned block
+                                  block_buffer_tail;    // Index of the busy block, if any
     static uint16_t cleaning_buffer_counter;        // A counter to disable queuing of blocks
     static uint8_t delay_before_delivering;         // This counter delays delivery of blocks when queue becomes empty to allow the opportunity of merging blocks
 
@@ -286,6 +309,9 @@ class Planner {
 
     #if ENABLED(LIN_ADVANCE)
       static float extruder_advance_K[EXTRUDERS];
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        static float advance_smooth_time;   // (s) Time to spread pressure changes over (M900 W)
+      #endif
     #endif
 
     #if HAS_POSITION_FLOAT
@@ -333,7 +359,7 @@ class Planner {
       /**
        * Counters to manage disabling inactive extruders
        */
-      static uint8_t g_uc_extruder_last_move[EXTRUDERS];
+      static uint16_t g_uc_extruder_last_move[EXTRUDERS];
     #endif // DISABLE_INACTIVE_EXTRUDER
 
     #ifdef XY_FREQUENCY_LIMIT
@@ -540,10 +566,10 @@ class Planner {
     #endif // HAS_POSITION_MODIFIERS
 
     // Number of moves currently in the planner including the busy block, if any
-    FORCE_INLINE static uint8_t movesplanned() { return BLOCK_MOD(block_buffer_head - block_buffer_tail); }
+    FORCE_INLINE static block_index_t movesplanned() { return BLOCK_MOD(block_buffer_head - block_buffer_tail); }
 
     // Number of nonbusy moves currently in the planner
-    FORCE_INLINE static uint8_t nonbusy_movesplanned() { return BLOCK_MOD(block_buffer_head - block_buffer_nonbusy); }
+    FORCE_INLINE static block_index_t nonbusy_movesplanned() { return BLOCK_MOD(block_buffer_head - block_buffer_nonbusy); }
 
     // Remove all blocks from the buffer
     FORCE_INLINE static void clear_block_buffer() { block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail = 0; }
@@ -552,7 +578,7 @@ class Planner {
     FORCE_INLINE static bool is_full() { return block_buffer_tail == next_block_index(block_buffer_head); }
 
     // Get count of movement slots free
-    FORCE_INLINE static uint8_t moves_free() { return BLOCK_BUFFER_SIZE - 1 - movesplanned(); }
+    FORCE_INLINE static block_index_t moves_free() { return BLOCK_BUFFER_SIZE - 1 - movesplanned(); }
 
     /**
      * Planner::get_next_free_block
@@ -561,7 +587,7 @@ class Planner {
      * - Wait for the number of spaces to open up in the planner
      * - Return the first head block
      */
-    FORCE_INLINE static block_t* get_next_free_block(uint8_t &next_buffer_head, const uint8_t count=1) {
+    FORCE_INLINE static block_t* get_next_free_block(block_index_t &next_buffer_head, const uint8_t count=1) {
 
       // Wait until there are enough slots free
       while (moves_free() < count) { idle(); }
@@ -692,6 +718,17 @@ class Planner {
       );
     }
 
+    #if ENABLED(SEGMENT_COALESCING)
+      /**
+       * Queue the held-back merged move, if any. Call this before anything
+       * that changes the planner position or must follow the move in order.
+       */
+      static void flush_coalesced();
+
+      // Don't let the held-back move wait once the planner is about to run dry
+      FORCE_INLINE static void coalesce_idle() { if (coalesce.count && movesplanned() <= 1) flush_coalesced(); }
+    #endif
+
     /**
      * Set the planner.position and individual stepper positions.
      * Used by G92, G28, G29, and other procedures.
@@ -769,7 +806,7 @@ class Planner {
     static block_t* get_current_block() {
 
       // Get the number of moves in the planner queue so far
-      const uint8_t nr_moves = movesplanned();
+      const block_index_t nr_moves = movesplanned();
 
       // If there are any moves queued ...
       if (nr_moves) {
@@ -890,8 +927,8 @@ class Planner {
     /**
      * Get the index of the next / previous block in the ring buffer
      */
-    static constexpr uint8_t next_block_index(const uint8_t block_index) { return BLOCK_MOD(block_index + 1); }
-    static constexpr uint8_t prev_block_index(const uint8_t block_index) { return BLOCK_MOD(block_index - 1); }
+    static constexpr block_index_t next_block_index(const block_index_t block_index) { return BLOCK_MOD(block_index + 1); }
+    static constexpr block_index_t prev_block_index(const block_index_t block_index) { return BLOCK_MOD(block_index - 1); }
 
     /**
      * Calculate the distance (not time) it takes to accelerate
@@ -934,17 +971,32 @@ class Planner {
     #endif
 
     static void calculate_trapezoid_for_block(block_t* const block, const float &entry_factor, const float &exit_factor);
+    #if ENABLED(SMOOTH_LIN_ADVANCE)
+      static void calculate_smooth_advance(block_t* const block);
+    #endif
+    #if DISABLED(PLANNER_FIXED_POINT) || ENABLED(MOTION_BENCHMARK)
+      static void calculate_trapezoid_float(block_t* const block, const float &entry_factor, const float &exit_factor);
+    #endif
+    #if ENABLED(PLANNER_FIXED_POINT)
+      static void calculate_trapezoid_fixed(block_t* const block, const uint32_t entry_factor, const uint32_t exit_factor);
+    #endif
 
     static void reverse_pass_kernel(block_t* const current, const block_t * const next);
-    static void forward_pass_kernel(const block_t * const previous, block_t* const current, uint8_t block_index);
+    static void forward_pass_kernel(const block_t * const previous, block_t* const current, block_index_t block_index);
 
-    static void reverse_pass();
-    static void forward_pass();
+    static block_index_t reverse_pass();
+    static void forward_pass(const block_index_t first);
 
-    static void recalculate_trapezoids();
+    static void recalculate_trapezoids(const block_index_t first);
 
     static void recalculate();
 
+    #if ENABLED(SEGMENT_COALESCING)
+      static coalesce_t coalesce;
+      static bool coalesce_append(const xyze_pos_t &target, const feedRate_t &fr_mm_s, const uint8_t extruder);
+      static bool coalesce_segment(xyze_pos_t &target, const feedRate_t &fr_mm_s, const uint8_t extruder, const float &millimeters);
+    #endif
+
     #if DISABLED(CLASSIC_JERK)
 
       FORCE_INLINE static void normalize_junction_vector(xyze_float_t &vector) {
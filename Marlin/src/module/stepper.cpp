@@ -105,6 +105,10 @@ Stepper stepper; // Singleton
   #include "../feature/dac/dac_dac084s085.h"
 #endif
 
+#if ENABLED(MOTION_BENCHMARK)
+  #include "../feature/benchmark.h"
+#endif
+
 #if HAS_DIGIPOTSS
   #include <SPI.h>
 #endif
@@ -164,6 +168,12 @@ bool Stepper::abort_current_block;
 uint32_t Stepper::acceleration_time, Stepper::deceleration_time;
 uint8_t Stepper::steps_per_isr;
 
+#if ENABLED(ADAPTIVE_MULTI_STEPPING)
+  uint32_t Stepper::isr_cycles[8],
+           Stepper::isr_rate_limit[8];
+  uint8_t Stepper::isr_load = MULTI_STEPPING_ISR_LOAD;
+#endif
+
 #if DISABLED(ADAPTIVE_STEP_SMOOTHING)
   constexpr
 #endif
@@ -200,9 +210,17 @@ uint32_t Stepper::nextMainISR = 0;
 
 #if ENABLED(LIN_ADVANCE)
 
-  constexpr uint32_t LA_ADV_NEVER = 0xFFFFFFFF;
-  uint32_t Stepper::nextAdvanceISR = LA_ADV_NEVER,
-           Stepper::LA_isr_rate = LA_ADV_NEVER;
+  #if ENABLED(SMOOTH_LIN_ADVANCE)
+    constexpr int32_t LA_ADV_STEPS_PER_EVENT = 4; // Advance steps the pulse phase may add to one step event
+    uint32_t Stepper::LA_phase_end;
+    int32_t Stepper::LA_adv_error, Stepper::LA_adv_dividend, Stepper::LA_adv_divisor;
+    int8_t Stepper::LA_adv_dir = 0, Stepper::LA_e_dir = 0;
+    uint8_t Stepper::LA_phase;
+  #else
+    constexpr uint32_t LA_ADV_NEVER = 0xFFFFFFFF;
+    uint32_t Stepper::nextAdvanceISR = LA_ADV_NEVER,
+             Stepper::LA_isr_rate = LA_ADV_NEVER;
+  #endif
   uint16_t Stepper::LA_current_adv_steps = 0,
            Stepper::LA_final_adv_steps,
            Stepper::LA_max_adv_steps;
@@ -213,11 +231,29 @@ uint32_t Stepper::nextMainISR = 0;
 
 #endif // LIN_ADVANCE
 
+#if ENABLED(INPUT_SHAPING)
+
+  constexpr uint32_t SHAPING_NEVER = 0xFFFFFFFF;
+
+  shaper_settings_t Stepper::shaper_settings[2];
+  Stepper::shaper_t Stepper::shaper[2] = { { 1, { 0 }, { 65536 } }, { 1, { 0 }, { 65536 } } };
+  Stepper::shaping_queue_t Stepper::shaping_queue[2];
+  uint32_t Stepper::nextShapingISR = SHAPING_NEVER,
+           Stepper::shaping_time;
+
+#endif
+
 int32_t Stepper::ticks_nominal = -1;
 #if DISABLED(S_CURVE_ACCELERATION)
   uint32_t Stepper::acc_step_rate; // needed for deceleration start point
 #endif
 
+#if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+  Stepper::step_schedule_t Stepper::step_schedule[2];
+  Stepper::step_schedule_t *Stepper::active_schedule;
+  uint8_t Stepper::schedule_accel_index, Stepper::schedule_decel_index;
+#endif
+
 xyz_long_t Stepper::endstops_trigsteps;
 xyze_long_t Stepper::count_position{0};
 xyze_int8_t Stepper::count_direction{0};
@@ -371,12 +407,19 @@ void Stepper::set_directions() {
       count_direction[_AXIS(A)] = 1;            \
     }
 
-  #if HAS_X_DIR
-    SET_STEP_DIR(X); // A
-  #endif
+  #if ENABLED(INPUT_SHAPING)
+    // The X and Y direction pins follow the shaped steps (see shaping_isr)
+    #define SET_COUNT_DIR(A) count_direction[_AXIS(A)] = motor_direction(_AXIS(A)) ? -1 : 1
+    SET_COUNT_DIR(X);
+    SET_COUNT_DIR(Y);
+  #else
+    #if HAS_X_DIR
+      SET_STEP_DIR(X); // A
+    #endif
 
-  #if HAS_Y_DIR
-    SET_STEP_DIR(Y); // B
+    #if HAS_Y_DIR
+      SET_STEP_DIR(Y); // B
+    #endif
   #endif
 
   #if HAS_Z_DIR
@@ -405,6 +448,10 @@ void Stepper::set_directions() {
         count_direction.e = 1;
       }
     #endif
+  #elif ENABLED(SMOOTH_LIN_ADVANCE)
+    // The E pin is set as the advanced E steps are output
+    count_direction.e = motor_direction(E_AXIS) ? -1 : 1;
+    LA_e_dir = 0;
   #endif // !LIN_ADVANCE
 
   #if HAS_DRIVER(L6470)
@@ -574,6 +621,23 @@ void Stepper::set_directions() {
    *
    *  This is rewritten in ARM assembly for optimal performance (43 cycles to execute).
    *
+   *  Cortex-M4/M7 have the DSP extension, whose SMMUL / SMMLA give the upper word of a signed
+   *  32x32 product (plus an accumulator) in a single cycle. With t as Q31 the same coefficients
+   *  are evaluated with Horner's rule in five multiplies, each halving the result:
+   *
+   *      int32_t _eval_bezier_curve_horner(uint32_t curr_step) {
+   *        int32_t u = (bezier_AV * curr_step) >> 1;   // t: Q31
+   *        int32_t h = smmla(bezier_A, u, bezier_B >> 1);  // (B + A*t) / 2
+   *        h = smmla(h, u, bezier_C >> 2);             // (C + B*t + A*t^2) / 4
+   *        h = smmul(h, u);                            // ... * t / 8
+   *        h = smmul(h, u);                            // ... * t^2 / 16
+   *        h = smmul(h, u);                            // (C*t^3 + B*t^4 + A*t^5) / 32
+   *        return (bezier_F + h * 32) >> 7;
+   *      }
+   *
+   *  That is about 12 cycles, and the result stays within 1 step/s of the 64-bit version.
+   *  (With MOTION_BENCHMARK and S_CURVE_ACCELERATION the simulator checks every evaluation.)
+   *
    *  For AVR, the precision of coefficients is scaled so the Bézier curve can be evaluated in real-time:
    *  Let's reduce precision as much as possible. After some experimentation we found that:
    *
@@ -1171,8 +1235,40 @@ void Stepper::set_directions() {
       bezier_AV = av;
     }
 
+    // Upper word of a signed 32x32 multiply (with accumulate)
+    #ifdef __ARM_FEATURE_DSP
+      FORCE_INLINE static int32_t smmul(const int32_t a, const int32_t b) {
+        int32_t r;
+        __asm__("smmul %0,%1,%2" : "=r"(r) : "r"(a), "r"(b));
+        return r;
+      }
+      FORCE_INLINE static int32_t smmla(const int32_t a, const int32_t b, const int32_t acc) {
+        int32_t r;
+        __asm__("smmla %0,%1,%2,%3" : "=r"(r) : "r"(a), "r"(b), "r"(acc));
+        return r;
+      }
+    #else
+      FORCE_INLINE static int32_t smmul(const int32_t a, const int32_t b) { return int32_t((int64_t(a) * b) >> 32); }
+      FORCE_INLINE static int32_t smmla(const int32_t a, const int32_t b, const int32_t acc) { return acc + smmul(a, b); }
+    #endif
+
+    FORCE_INLINE int32_t Stepper::_eval_bezier_curve_horner(const uint32_t curr_step) {
+      const int32_t u = (bezier_AV * curr_step) >> 1;   // t: Range 0 - 1^31 = 31 bits (Q31)
+      int32_t h = smmla(bezier_A, u, bezier_B >> 1);    // (B + A*t) / 2
+      h = smmla(h, u, bezier_C >> 2);                   // (C + B*t + A*t^2) / 4
+      h = smmul(h, u);                                  // (C*t + B*t^2 + A*t^3) / 8
+      h = smmul(h, u);                                  // (C*t^2 + B*t^3 + A*t^4) / 16
+      h = smmul(h, u);                                  // (C*t^3 + B*t^4 + A*t^5) / 32
+      return (bezier_F + h * 32) >> 7;                  // Range 24bits (plus sign)
+    }
+
     FORCE_INLINE int32_t Stepper::_eval_bezier_curve(const uint32_t curr_step) {
-      #if defined(__ARM__) || defined(__thumb__)
+      #ifdef __ARM_FEATURE_DSP
+
+        // For ARM Cortex M4/M7 CPUs, Horner's rule on the DSP extension takes about 12 cycles
+        return _eval_bezier_curve_horner(curr_step);
+
+      #elif defined(__ARM__) || defined(__thumb__)
 
         // For ARM Cortex M3/M4 CPUs, we have the optimized assembler version, that takes 43 cycles to execute
         uint32_t flo = 0;
@@ -1232,6 +1328,12 @@ void Stepper::set_directions() {
         f >>= 32;                                         // Range 32 bits : f = t^3  (unsigned)
         acc += ((uint32_t) f >> 1) * (int64_t) bezier_A;  // Range 28bits + 31 = 59bits (plus sign)
         acc >>= (31 + 7);                                 // Range 24bits (plus sign)
+
+        #if ENABLED(MOTION_BENCHMARK)
+          // Check the Horner / DSP version against this one
+          benchmark.compare_bezier((int32_t) acc, _eval_bezier_curve_horner(curr_step));
+        #endif
+
         return (int32_t) acc;
 
       #endif
@@ -1248,8 +1350,16 @@ void Stepper::set_directions() {
 HAL_STEP_TIMER_ISR() {
   HAL_timer_isr_prologue(STEP_TIMER_NUM);
 
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.interrupt_start();
+  #endif
+
   Stepper::isr();
 
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.interrupt_end();
+  #endif
+
   HAL_timer_isr_epilogue(STEP_TIMER_NUM);
 }
 
@@ -1260,6 +1370,10 @@ HAL_STEP_TIMER_ISR() {
 #endif
 
 void Stepper::isr() {
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.isr_start();
+  #endif
+
   #ifndef __AVR__
     // Disable interrupts, to avoid ISR preemption while we reprogram the period
     // (AVR enters the ISR with global interrupts disabled, so no need to do it here)
@@ -1283,38 +1397,74 @@ void Stepper::isr() {
     // Enable ISRs to reduce USART processing latency
     ENABLE_ISRS();
 
+    #if ENABLED(INPUT_SHAPING)
+      // Output the X / Y steps whose impulses are due
+      if (!nextShapingISR) nextShapingISR = Stepper::shaping_isr();
+
+      // Hold the main ISR until the delayed impulses make room for its steps
+      if (!nextMainISR && !shaping_has_room()) {
+        nextMainISR = _MIN(nextShapingISR, uint32_t(STEPPER_TIMER_RATE) / 1000);
+        #if ENABLED(MOTION_BENCHMARK)
+          benchmark.shaping_holds++;
+        #endif
+      }
+    #endif
+
     // Run main stepping pulse phase ISR if we have to
     if (!nextMainISR) Stepper::stepper_pulse_phase_isr();
 
-    #if ENABLED(LIN_ADVANCE)
+    #if HAS_ADVANCE_ISR
       // Run linear advance stepper ISR if we have to
       if (!nextAdvanceISR) nextAdvanceISR = Stepper::advance_isr();
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      // Output the steps the pulse phase just queued, for the impulses without delay
+      if (!nextShapingISR) nextShapingISR = Stepper::shaping_isr();
+    #endif
+
     // ^== Time critical. NOTHING besides pulse generation should be above here!!!
 
     // Run main stepping block processing ISR if we have to
-    if (!nextMainISR) nextMainISR = Stepper::stepper_block_phase_isr();
+    if (!nextMainISR) {
+      #if ENABLED(MOTION_BENCHMARK)
+        benchmark.block_phase_start();
+      #endif
+      nextMainISR = Stepper::stepper_block_phase_isr();
+      #if ENABLED(MOTION_BENCHMARK)
+        benchmark.block_phase_end();
+      #endif
+    }
 
     uint32_t interval =
-      #if ENABLED(LIN_ADVANCE)
+      #if HAS_ADVANCE_ISR
         _MIN(nextAdvanceISR, nextMainISR)  // Nearest time interval
       #else
         nextMainISR                       // Remaining stepper ISR time
       #endif
     ;
 
+    #if ENABLED(INPUT_SHAPING)
+      NOMORE(interval, nextShapingISR);
+    #endif
+
     // Limit the value to the maximum possible value of the timer
     NOMORE(interval, uint32_t(HAL_TIMER_TYPE_MAX));
 
     // Compute the time remaining for the main isr
     nextMainISR -= interval;
 
-    #if ENABLED(LIN_ADVANCE)
+    #if HAS_ADVANCE_ISR
       // Compute the time remaining for the advance isr
       if (nextAdvanceISR != LA_ADV_NEVER) nextAdvanceISR -= interval;
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      // Compute the time remaining for the next impulse
+      if (nextShapingISR != SHAPING_NEVER) nextShapingISR -= interval;
+      shaping_time += interval;
+    #endif
+
     /**
      * This needs to avoid a race-condition caused by interleaving
      * of interrupts required by both the LA and Stepper algorithms.
@@ -1377,12 +1527,26 @@ void Stepper::isr() {
     // Advance pulses if not enough time to wait for the next ISR
   } while (next_isr_ticks < min_ticks);
 
+  #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+    // Measure the cost of each pass through the loop above. The timer restarted from 0
+    // when this ISR fired, so its count is the time spent so far (including latency).
+    if (current_block) {
+      const uint32_t cycles = uint32_t(HAL_timer_get_count(STEP_TIMER_NUM)) * (STEPPER_TIMER_PRESCALE) / (10 - max_loops);
+      uint32_t &peak = isr_cycles[__builtin_ctz(steps_per_isr)];
+      peak = cycles > peak ? cycles : peak - (peak >> 10);
+    }
+  #endif
+
   // Now 'next_isr_ticks' contains the period to the next Stepper ISR - And we are
   // sure that the time has not arrived yet - Warrantied by the scheduler
 
   // Set the next ISR to fire at the proper time
   HAL_timer_set_compare(STEP_TIMER_NUM, hal_timer_t(next_isr_ticks));
 
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.isr_end();
+  #endif
+
   // Don't forget to finally reenable interrupts
   ENABLE_ISRS();
 }
@@ -1404,6 +1568,9 @@ void Stepper::stepper_pulse_phase_isr() {
       current_block = nullptr;
       planner.discard_current_block();
     }
+    #if ENABLED(INPUT_SHAPING)
+      shaping_flush();
+    #endif
   }
 
   // If there is no current block, do nothing
@@ -1416,6 +1583,10 @@ void Stepper::stepper_pulse_phase_isr() {
   // Just update the value we will get at the end of the loop
   step_events_completed += events_to_do;
 
+  #if ENABLED(MOTION_BENCHMARK)
+    benchmark.step_events += events_to_do;
+  #endif
+
   // Get the timer count and estimate the end of the pulse
   hal_timer_t pulse_end = HAL_timer_get_count(PULSE_TIMER_NUM) + hal_timer_t(MIN_PULSE_TICKS);
 
@@ -1444,12 +1615,31 @@ void Stepper::stepper_pulse_phase_isr() {
       } \
     }while(0)
 
+    // Queue the step for the input shaper, if Bresenham says so, and update position
+    #define SHAPE_STEP(AXIS) do{ \
+      delta_error[_AXIS(AXIS)] += advance_dividend[_AXIS(AXIS)]; \
+      if (delta_error[_AXIS(AXIS)] >= 0) { \
+        delta_error[_AXIS(AXIS)] -= advance_divisor; \
+        shaping_queue_t &q = shaping_queue[_AXIS(AXIS)]; \
+        q.step_time[q.head] = (shaping_time & ~1UL) | (count_direction[_AXIS(AXIS)] < 0); \
+        q.head = SHAPING_MOD(q.head + 1); \
+        q.lag += count_direction[_AXIS(AXIS)]; \
+        count_position[_AXIS(AXIS)] += count_direction[_AXIS(AXIS)]; \
+        nextShapingISR = 0; \
+      } \
+    }while(0)
+
     // Pulse start
-    #if HAS_X_STEP
-      PULSE_START(X);
-    #endif
-    #if HAS_Y_STEP
-      PULSE_START(Y);
+    #if ENABLED(INPUT_SHAPING)
+      SHAPE_STEP(X);
+      SHAPE_STEP(Y);
+    #else
+      #if HAS_X_STEP
+        PULSE_START(X);
+      #endif
+      #if HAS_Y_STEP
+        PULSE_START(Y);
+      #endif
     #endif
     #if HAS_Z_STEP
       PULSE_START(Z);
@@ -1477,6 +1667,37 @@ void Stepper::stepper_pulse_phase_isr() {
       #endif
     #endif
 
+    #if ENABLED(SMOOTH_LIN_ADVANCE)
+      // Add the advance steps due now, up to LA_ADV_STEPS_PER_EVENT
+      if (LA_adv_dir) {
+        LA_adv_error += LA_adv_dividend;
+        while (LA_adv_error >= 0) {
+          LA_adv_error -= LA_adv_divisor;
+          LA_steps += LA_adv_dir;
+          LA_current_adv_steps += LA_adv_dir;
+        }
+      }
+
+      // Step E with the other axes, setting its direction first if needed
+      if (LA_steps) {
+        const int8_t dir = LA_steps > 0 ? 1 : -1;
+        if (dir != LA_e_dir) {
+          #if MINIMUM_STEPPER_PRE_DIR_DELAY > 0
+            DELAY_NS(MINIMUM_STEPPER_PRE_DIR_DELAY);
+          #endif
+          if (dir > 0)
+            NORM_E_DIR(stepper_extruder);
+          else
+            REV_E_DIR(stepper_extruder);
+          LA_e_dir = dir;
+          #if MINIMUM_STEPPER_POST_DIR_DELAY > 0
+            DELAY_NS(MINIMUM_STEPPER_POST_DIR_DELAY);
+          #endif
+        }
+        E_STEP_WRITE(stepper_extruder, !INVERT_E_STEP_PIN);
+      }
+    #endif
+
     #if ENABLED(I2S_STEPPER_STREAM)
       i2s_push_sample();
     #endif
@@ -1491,11 +1712,13 @@ void Stepper::stepper_pulse_phase_isr() {
     if (signed(added_step_ticks) > 0) pulse_end += hal_timer_t(added_step_ticks);
 
     // Pulse stop
-    #if HAS_X_STEP
-      PULSE_STOP(X);
-    #endif
-    #if HAS_Y_STEP
-      PULSE_STOP(Y);
+    #if DISABLED(INPUT_SHAPING)
+      #if HAS_X_STEP
+        PULSE_STOP(X);
+      #endif
+      #if HAS_Y_STEP
+        PULSE_STOP(Y);
+      #endif
     #endif
     #if HAS_Z_STEP
       PULSE_STOP(Z);
@@ -1512,6 +1735,20 @@ void Stepper::stepper_pulse_phase_isr() {
           PULSE_STOP(E);
         #endif
       #endif
+    #elif ENABLED(SMOOTH_LIN_ADVANCE)
+      if (LA_steps) {
+        E_STEP_WRITE(stepper_extruder, INVERT_E_STEP_PIN);
+        // Any further E steps get pulses of their own
+        for (uint8_t n = ABS(LA_steps); --n;) {
+          while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+          pulse_end += hal_timer_t(MIN_PULSE_TICKS);
+          E_STEP_WRITE(stepper_extruder, !INVERT_E_STEP_PIN);
+          while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+          if (signed(added_step_ticks) > 0) pulse_end += hal_timer_t(added_step_ticks);
+          E_STEP_WRITE(stepper_extruder, INVERT_E_STEP_PIN);
+        }
+        LA_steps = 0;
+      }
     #endif // !LIN_ADVANCE
 
     // Decrement the count of pending pulses to do
@@ -1547,13 +1784,24 @@ uint32_t Stepper::stepper_block_phase_isr() {
       #ifdef FILAMENT_RUNOUT_DISTANCE_MM
         runout.block_completed(current_block);
       #endif
+      #if BOTH(MOTION_BENCHMARK, LIN_ADVANCE)
+        if (LA_use_advance_lead) benchmark.advance_done(LA_current_adv_steps, LA_final_adv_steps);
+      #endif
       axis_did_move = 0;
       current_block = nullptr;
+      #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+        active_schedule = nullptr;
+      #endif
       planner.discard_current_block();
     }
     else {
       // Step events not completed yet...
 
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        // Plan the advance for the next phase of the trapezoid
+        if (LA_use_advance_lead && step_events_completed >= LA_phase_end) smooth_advance_phase();
+      #endif
+
       // Are we in acceleration phase ?
       if (step_events_completed <= accelerate_until) { // Calculate new timer value
 
@@ -1563,6 +1811,21 @@ uint32_t Stepper::stepper_block_phase_isr() {
             acceleration_time < current_block->acceleration_time
               ? _eval_bezier_curve(acceleration_time)
               : current_block->cruise_rate;
+        #elif ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+          // Take the interval from the schedule, as long as it lasts
+          if (active_schedule && schedule_accel_index < active_schedule->accel_count) {
+            const step_timing_t &timing = active_schedule->accel[schedule_accel_index++];
+            interval = timing.interval;
+            steps_per_isr = timing.loops;
+            #if ENABLED(MOTION_BENCHMARK)
+              benchmark.scheduled_intervals++;
+            #endif
+          }
+          else {
+            acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
+            NOMORE(acc_step_rate, current_block->nominal_rate);
+            interval = calc_timer_interval(acc_step_rate, oversampling_factor, &steps_per_isr);
+          }
         #else
           acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
           NOMORE(acc_step_rate, current_block->nominal_rate);
@@ -1571,10 +1834,12 @@ uint32_t Stepper::stepper_block_phase_isr() {
         // acc_step_rate is in steps/second
 
         // step_rate to timer interval and steps per stepper isr
-        interval = calc_timer_interval(acc_step_rate, oversampling_factor, &steps_per_isr);
+        #if DISABLED(PRECOMPUTED_STEP_SCHEDULE)
+          interval = calc_timer_interval(acc_step_rate, oversampling_factor, &steps_per_isr);
+        #endif
         acceleration_time += interval;
 
-        #if ENABLED(LIN_ADVANCE)
+        #if HAS_ADVANCE_ISR
           if (LA_use_advance_lead) {
             // Fire ISR if final adv_rate is reached
             if (LA_steps && LA_isr_rate != current_block->advance_speed) nextAdvanceISR = 0;
@@ -1586,6 +1851,19 @@ uint32_t Stepper::stepper_block_phase_isr() {
       else if (step_events_completed > decelerate_after) {
         uint32_t step_rate;
 
+        #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+          // The schedule is only good if the acceleration peaked where it was expected to
+          if (active_schedule && schedule_decel_index < active_schedule->decel_count && acc_step_rate == active_schedule->peak_rate) {
+            const step_timing_t &timing = active_schedule->decel[schedule_decel_index++];
+            interval = timing.interval;
+            steps_per_isr = timing.loops;
+            #if ENABLED(MOTION_BENCHMARK)
+              benchmark.scheduled_intervals++;
+            #endif
+          }
+          else {
+        #endif
+
         #if ENABLED(S_CURVE_ACCELERATION)
           // If this is the 1st time we process the 2nd half of the trapezoid...
           if (!bezier_2nd_half) {
@@ -1617,9 +1895,14 @@ uint32_t Stepper::stepper_block_phase_isr() {
 
         // step_rate to timer interval and steps per stepper isr
         interval = calc_timer_interval(step_rate, oversampling_factor, &steps_per_isr);
+
+        #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+          }
+        #endif
+
         deceleration_time += interval;
 
-        #if ENABLED(LIN_ADVANCE)
+        #if HAS_ADVANCE_ISR
           if (LA_use_advance_lead) {
             // Wake up eISR on first deceleration loop and fire ISR if final adv_rate is reached
             if (step_events_completed <= decelerate_after + steps_per_isr || (LA_steps && LA_isr_rate != current_block->advance_speed)) {
@@ -1633,7 +1916,7 @@ uint32_t Stepper::stepper_block_phase_isr() {
       // We must be in cruise phase otherwise
       else {
 
-        #if ENABLED(LIN_ADVANCE)
+        #if HAS_ADVANCE_ISR
           // If there are any esteps, fire the next advance_isr "now"
           if (LA_steps && LA_isr_rate != current_block->advance_speed) nextAdvanceISR = 0;
         #endif
@@ -1798,11 +2081,28 @@ uint32_t Stepper::stepper_block_phase_isr() {
         if ((LA_use_advance_lead = current_block->use_advance_lead)) {
           LA_final_adv_steps = current_block->final_adv_steps;
           LA_max_adv_steps = current_block->max_adv_steps;
-          //Start the ISR
-          nextAdvanceISR = 0;
-          LA_isr_rate = current_block->advance_speed;
+          #if ENABLED(SMOOTH_LIN_ADVANCE)
+            // Plan the advance for the acceleration
+            LA_phase = 0;
+            LA_phase_end = accelerate_until;
+            smooth_advance_phase();
+          #else
+            //Start the ISR
+            nextAdvanceISR = 0;
+            LA_isr_rate = current_block->advance_speed;
+          #endif
+        }
+        else {
+          #if ENABLED(SMOOTH_LIN_ADVANCE)
+            // Release what is left of the pressure during this move
+            LA_max_adv_steps = LA_final_adv_steps = 0;
+            LA_phase = 2;
+            LA_phase_end = step_event_count;
+            smooth_advance_phase();
+          #else
+            LA_isr_rate = LA_ADV_NEVER;
+          #endif
         }
-        else LA_isr_rate = LA_ADV_NEVER;
       #endif
 
       if (
@@ -1853,16 +2153,43 @@ uint32_t Stepper::stepper_block_phase_isr() {
         bezier_2nd_half = false;
       #endif
 
+      #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+        // Use the schedule made in the background if the block hasn't been replanned since
+        active_schedule = nullptr;
+        LOOP_L_N(i, COUNT(step_schedule))
+          if (step_schedule[i].ready && schedule_matches(step_schedule[i], current_block)) {
+            active_schedule = &step_schedule[i];
+            break;
+          }
+        if (active_schedule) {
+          schedule_accel_index = schedule_decel_index = 0;
+          acc_step_rate = active_schedule->peak_rate;
+          interval = active_schedule->start.interval;
+          steps_per_isr = active_schedule->start.loops;
+          #if ENABLED(MOTION_BENCHMARK)
+            benchmark.scheduled_blocks++;
+          #endif
+        }
+        else
+      #endif
       // Calculate the initial timer interval
       interval = calc_timer_interval(current_block->initial_rate, oversampling_factor, &steps_per_isr);
+
+      #if ENABLED(MOTION_BENCHMARK)
+        benchmark.block_started(*current_block);
+      #endif
     }
+    #if ENABLED(MOTION_BENCHMARK)
+      else
+        benchmark.block_missed();
+    #endif
   }
 
   // Return the interval to wait
   return interval;
 }
 
-#if ENABLED(LIN_ADVANCE)
+#if HAS_ADVANCE_ISR
 
   // Timer interrupt for E. LA_steps is set in the main routine
   uint32_t Stepper::advance_isr() {
@@ -1955,6 +2282,35 @@ uint32_t Stepper::stepper_block_phase_isr() {
 
     return interval;
   }
+
+#elif ENABLED(SMOOTH_LIN_ADVANCE)
+
+  /**
+   * Move the pressure part of the way to the advance wanted at the end of the next
+   * trapezoid phase (all the way without smoothing, see Planner::calculate_smooth_advance)
+   * and spread the steps this takes over the step events of the phase. The pulse
+   * phase adds them to the E steps, so the extruder needs no ISR of its own.
+   */
+  void Stepper::smooth_advance_phase() {
+    // Skip the phases that are over or empty
+    while (LA_phase < 2 && step_events_completed >= LA_phase_end)
+      LA_phase_end = ++LA_phase == 1 ? decelerate_after : step_event_count;
+
+    const int32_t events = LA_phase_end - step_events_completed,
+                  target = LA_phase < 2 ? LA_max_adv_steps : LA_final_adv_steps,
+                  share = LA_use_advance_lead ? current_block->adv_smoothing[LA_phase] : 256,
+                  change = ((target - int32_t(LA_current_adv_steps)) * share) >> 8;
+
+    if (change && events > 0) {
+      LA_adv_dir = change < 0 ? -1 : 1;
+      LA_adv_dividend = _MIN(ABS(change), events * (LA_ADV_STEPS_PER_EVENT)) << 1;
+      LA_adv_divisor = events << 1;
+      LA_adv_error = -events;
+    }
+    else
+      LA_adv_dir = 0;
+  }
+
 #endif // LIN_ADVANCE
 
 // Check if the given block is busy or not - Must not be called from ISR contexts
@@ -1987,6 +2343,10 @@ bool Stepper::is_block_busy(const block_t* const block) {
 
 void Stepper::init() {
 
+  #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+    reset_isr_limits();
+  #endif
+
   #if MB(ALLIGATOR)
     const float motor_current[] = MOTOR_CURRENT;
     unsigned int digipot_motor = 0;
@@ -2239,6 +2599,11 @@ void Stepper::endstop_triggered(const AxisEnum axis) {
   const bool was_enabled = STEPPER_ISR_ENABLED();
   if (was_enabled) DISABLE_STEPPER_DRIVER_INTERRUPT();
 
+  #if ENABLED(INPUT_SHAPING)
+    // The endstop saw the shaped position, so stop there
+    shaping_flush();
+  #endif
+
   #if IS_CORE
     #ifdef ARDUINO_ARCH_ESP32 // avoid float operation on ESP32 during interrupts
     endstops_trigsteps[axis] = (
@@ -2308,6 +2673,348 @@ void Stepper::report_positions() {
   #endif
 }
 
+#if ENABLED(ADAPTIVE_MULTI_STEPPING)
+
+  // The ISR rate limits for 1x ... 128x stepping, from the cycle estimates above
+  static const uint32_t estimated_isr_rate_limit[] PROGMEM = {
+    (  MAX_STEP_ISR_FREQUENCY_1X     ),
+    (  MAX_STEP_ISR_FREQUENCY_2X >> 1),
+    (  MAX_STEP_ISR_FREQUENCY_4X >> 2),
+    (  MAX_STEP_ISR_FREQUENCY_8X >> 3),
+    ( MAX_STEP_ISR_FREQUENCY_16X >> 4),
+    ( MAX_STEP_ISR_FREQUENCY_32X >> 5),
+    ( MAX_STEP_ISR_FREQUENCY_64X >> 6),
+    (MAX_STEP_ISR_FREQUENCY_128X >> 7)
+  };
+
+  void Stepper::reset_isr_limits() {
+    for (uint8_t i = 0; i < 8; i++) {
+      isr_cycles[i] = 0;
+      isr_rate_limit[i] = pgm_read_dword(&estimated_isr_rate_limit[i]);
+    }
+  }
+
+  /**
+   * Allow each multi-stepping factor up to the ISR rate that keeps the stepper ISR
+   * within isr_load percent of the CPU. Factors not used yet are extrapolated from
+   * the next lower measured one, adding the estimated cost of the extra step loops.
+   * Factors below the lowest measured one keep their estimated limit.
+   */
+  void Stepper::update_isr_limits() {
+    const uint32_t budget = uint32_t(F_CPU) / 100 * isr_load; // ISR cycles available per second
+    uint32_t cycles = 0, prev_limit = UINT32_MAX;
+    for (uint8_t i = 0; i < 8; i++) {
+      if (isr_cycles[i])
+        cycles = isr_cycles[i];
+      else if (cycles)
+        cycles += uint32_t(ISR_LOOP_CYCLES) << (i - 1);
+      uint32_t limit = cycles ? budget / cycles : pgm_read_dword(&estimated_isr_rate_limit[i]);
+      NOMORE(limit, prev_limit);
+      isr_rate_limit[i] = prev_limit = limit;
+    }
+  }
+
+  void Stepper::report_isr_limits() {
+    SERIAL_ECHO_START();
+    SERIAL_ECHOLNPAIR("Stepper ISR load: ", int(isr_load), "%");
+    for (uint8_t i = 0; i < 8; i++) {
+      SERIAL_ECHO_START();
+      SERIAL_ECHOPAIR(" ", int(_BV(i)), "x up to ", isr_rate_limit[i] << i, " steps/s");
+      if (isr_cycles[i])
+        SERIAL_ECHOLNPAIR(", ISR ", isr_cycles[i], " cycles");
+      else
+        SERIAL_ECHOLNPGM(", ISR not measured");
+    }
+  }
+
+#endif // ADAPTIVE_MULTI_STEPPING
+
+#if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+
+  bool Stepper::schedule_matches(const step_schedule_t &sched, const block_t * const block) {
+    return sched.block == block
+        && sched.initial_rate == block->initial_rate
+        && sched.nominal_rate == block->nominal_rate
+        && sched.final_rate == block->final_rate
+        && sched.acceleration_rate == block->acceleration_rate
+        && sched.accelerate_until == block->accelerate_until
+        && sched.decelerate_after == block->decelerate_after
+        && sched.step_event_count == block->step_event_count;
+  }
+
+  /**
+   * Replay the trapezoid the way stepper_block_phase_isr() will run it, keeping the
+   * first STEP_SCHEDULE_SIZE intervals of each ramp. The deceleration depends on the
+   * rate reached at the end of the acceleration, so it is left to the live calculation
+   * when the acceleration is too long to follow to its end.
+   */
+  void Stepper::build_step_schedule(step_schedule_t &sched, block_t * const block) {
+    constexpr uint16_t max_replay = 2048;  // Acceleration ISRs followed past the table
+
+    sched.block = block;
+    sched.initial_rate = block->initial_rate;
+    sched.nominal_rate = block->nominal_rate;
+    sched.final_rate = block->final_rate;
+    sched.acceleration_rate = block->acceleration_rate;
+    sched.accelerate_until = block->accelerate_until;
+    sched.decelerate_after = block->decelerate_after;
+    sched.step_event_count = block->step_event_count;
+    sched.accel_count = sched.decel_count = 0;
+
+    uint8_t loops;
+    sched.start.interval = calc_timer_interval(block->initial_rate, 0, &loops);
+    sched.start.loops = loops;
+
+    // Acceleration: one interval per ISR while the completed steps stay within accelerate_until
+    uint32_t completed = 0, time = 0, rate = block->initial_rate;
+    uint16_t replayed = 0;
+    for (;;) {
+      completed += loops;
+      if (completed >= block->step_event_count || completed > block->accelerate_until) break;
+      if (++replayed > max_replay) { sched.peak_rate = 0; return; }
+      rate = STEP_MULTIPLY(time, block->acceleration_rate) + block->initial_rate;
+      NOMORE(rate, block->nominal_rate);
+      const uint32_t interval = calc_timer_interval(rate, 0, &loops);
+      time += interval;
+      if (sched.accel_count < STEP_SCHEDULE_SIZE) {
+        sched.accel[sched.accel_count].interval = interval;
+        sched.accel[sched.accel_count++].loops = loops;
+      }
+    }
+    sched.peak_rate = rate;
+
+    // Deceleration: starts over from the peak rate, for as many steps as the ramp has
+    const uint32_t decel_steps = block->step_event_count - block->decelerate_after;
+    uint32_t stepped = 0;
+    time = 0;
+    while (sched.decel_count < STEP_SCHEDULE_SIZE && stepped < decel_steps) {
+      uint32_t step_rate = STEP_MULTIPLY(time, block->acceleration_rate);
+      if (step_rate < rate) {
+        step_rate = rate - step_rate;
+        NOLESS(step_rate, block->final_rate);
+      }
+      else
+        step_rate = block->final_rate;
+      const uint32_t interval = calc_timer_interval(step_rate, 0, &loops);
+      time += interval;
+      stepped += loops;
+      sched.decel[sched.decel_count].interval = interval;
+      sched.decel[sched.decel_count++].loops = loops;
+    }
+  }
+
+  void Stepper::prepare_step_schedule() {
+    block_t *block = nullptr;
+    step_schedule_t *sched = nullptr;
+
+    // Pick the block after the one running and a slot the block phase isn't reading
+    const bool was_enabled = STEPPER_ISR_ENABLED();
+    if (was_enabled) DISABLE_STEPPER_DRIVER_INTERRUPT();
+    const block_index_t index = current_block ? BLOCK_MOD(planner.block_buffer_tail + 1) : planner.block_buffer_tail;
+    if (index != planner.block_buffer_head) {
+      block = &planner.block_buffer[index];
+      if (block->flag & (BLOCK_FLAG_SYNC_POSITION | BLOCK_FLAG_RECALCULATE))
+        block = nullptr;
+      else {
+        LOOP_L_N(i, COUNT(step_schedule))
+          if (step_schedule[i].ready && schedule_matches(step_schedule[i], block)) block = nullptr;
+        if (block) {
+          sched = &step_schedule[active_schedule == &step_schedule[0] ? 1 : 0];
+          sched->ready = false;
+        }
+      }
+    }
+    if (was_enabled) ENABLE_STEPPER_DRIVER_INTERRUPT();
+
+    if (!sched) return;
+
+    build_step_schedule(*sched, block);
+
+    if (was_enabled) DISABLE_STEPPER_DRIVER_INTERRUPT();
+    sched->ready = true;
+    if (was_enabled) ENABLE_STEPPER_DRIVER_INTERRUPT();
+  }
+
+#endif // PRECOMPUTED_STEP_SCHEDULE
+
+#if ENABLED(INPUT_SHAPING)
+
+  /**
+   * Input shaping
+   *
+   * Each X / Y step made by the pulse phase is queued with its time, and the output
+   * position follows the sum of its impulses: amplitude[i] of the step, delay[i] later.
+   * The impulses are chosen so the resonance they excite cancels out (ZV, ZVD, MZV).
+   * Whole steps are output here as the impulses add up, so this also drives the
+   * X / Y direction pins. Without shaping there is one impulse with no delay.
+   */
+  uint32_t Stepper::shaping_isr() {
+    uint32_t interval = SHAPING_NEVER;
+
+    LOOP_L_N(a, 2) {
+      const shaper_t &sh = shaper[a];
+      shaping_queue_t &q = shaping_queue[a];
+      LOOP_L_N(i, sh.count) {
+        uint16_t t = q.tail[i];
+        for (; t != q.head; t = SHAPING_MOD(t + 1)) {
+          const uint32_t step_time = q.step_time[t];
+          const int32_t wait = int32_t((step_time & ~1UL) + sh.delay[i] - shaping_time);
+          if (wait > 0) { NOMORE(interval, uint32_t(wait)); break; }
+          q.residual += TEST(step_time, 0) ? -sh.amplitude[i] : sh.amplitude[i];
+        }
+        q.tail[i] = t;
+      }
+    }
+
+    // Output whole steps, rounding the shaped position
+    shaping_queue_t &qx = shaping_queue[X_AXIS], &qy = shaping_queue[Y_AXIS];
+    #define SHAPED_STEP(Q) ((Q).residual >= 32768 ? 1 : (Q).residual < -32768 ? -1 : 0)
+
+    hal_timer_t pulse_end = HAL_timer_get_count(PULSE_TIMER_NUM) + hal_timer_t(MIN_PULSE_TICKS);
+    const hal_timer_t added_step_ticks = hal_timer_t(ADDED_STEP_TICKS);
+
+    for (;;) {
+      const int8_t sx = SHAPED_STEP(qx), sy = SHAPED_STEP(qy);
+      if (!sx && !sy) break;
+
+      const bool dir_x = sx && (sx < 0) != qx.reverse,
+                 dir_y = sy && (sy < 0) != qy.reverse;
+      if (dir_x || dir_y) {
+        #if MINIMUM_STEPPER_PRE_DIR_DELAY > 0
+          DELAY_NS(MINIMUM_STEPPER_PRE_DIR_DELAY);
+        #endif
+        if (dir_x) {
+          qx.reverse = sx < 0;
+          X_APPLY_DIR(qx.reverse ? INVERT_X_DIR : !INVERT_X_DIR, false);
+        }
+        if (dir_y) {
+          qy.reverse = sy < 0;
+          Y_APPLY_DIR(qy.reverse ? INVERT_Y_DIR : !INVERT_Y_DIR, false);
+        }
+        #if MINIMUM_STEPPER_POST_DIR_DELAY > 0
+          DELAY_NS(MINIMUM_STEPPER_POST_DIR_DELAY);
+        #endif
+      }
+
+      // Set the STEP pulses ON
+      if (sx) X_APPLY_STEP(!INVERT_X_STEP_PIN, 0);
+      if (sy) Y_APPLY_STEP(!INVERT_Y_STEP_PIN, 0);
+
+      // Enforce a minimum duration for STEP pulse ON
+      #if MINIMUM_STEPPER_PULSE
+        while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+      #endif
+
+      // Add the delay needed to ensure the maximum driver rate is enforced
+      if (signed(added_step_ticks) > 0) pulse_end += hal_timer_t(added_step_ticks);
+
+      // Set the STEP pulses OFF
+      if (sx) {
+        X_APPLY_STEP(INVERT_X_STEP_PIN, 0);
+        qx.residual -= sx * 65536L;
+        qx.lag -= sx;
+        #if ENABLED(MOTION_BENCHMARK)
+          benchmark.shaped_step(X_AXIS, sx, shaping_time);
+        #endif
+      }
+      if (sy) {
+        Y_APPLY_STEP(INVERT_Y_STEP_PIN, 0);
+        qy.residual -= sy * 65536L;
+        qy.lag -= sy;
+        #if ENABLED(MOTION_BENCHMARK)
+          benchmark.shaped_step(Y_AXIS, sy, shaping_time);
+        #endif
+      }
+
+      // For minimum pulse time wait before looping
+      while (HAL_timer_get_count(PULSE_TIMER_NUM) < pulse_end) { /* nada */ }
+      #if MINIMUM_STEPPER_PULSE
+        pulse_end += hal_timer_t(MIN_PULSE_TICKS);
+      #endif
+    }
+
+    return interval;
+  }
+
+  bool Stepper::shaping_has_room() {
+    LOOP_L_N(a, 2) {
+      const shaping_queue_t &q = shaping_queue[a];
+      if (SHAPING_MOD(q.tail[shaper[a].count - 1] - q.head - 1) < steps_per_isr) return false;
+    }
+    return true;
+  }
+
+  void Stepper::shaping_flush() {
+    LOOP_L_N(a, 2) {
+      shaping_queue_t &q = shaping_queue[a];
+      count_position[a] -= q.lag;
+      q.lag = q.residual = 0;
+      LOOP_L_N(i, COUNT(q.tail)) q.tail[i] = q.head;
+    }
+    nextShapingISR = SHAPING_NEVER;
+  }
+
+  bool Stepper::shaping_busy() {
+    LOOP_L_N(a, 2)
+      if (shaping_queue[a].tail[shaper[a].count - 1] != shaping_queue[a].head) return true;
+    return false;
+  }
+
+  void Stepper::update_shaper(const AxisEnum axis) {
+    const shaper_settings_t &ss = shaper_settings[axis];
+    shaper_t sh = { 1, { 0 }, { 65536 } };
+
+    if (ss.frequency > 0) {
+      const float zeta = constrain(ss.damping, 0, 0.99f),
+                  df = SQRT(1 - sq(zeta)),
+                  td = 1.0f / (ss.frequency * df);  // Period of the damped resonance (s)
+      float amp[3], when[3];
+      switch (ss.type) {
+        default:
+        case SHAPER_ZV: {
+          const float K = expf(-zeta * float(M_PI) / df);
+          sh.count = 2;
+          amp[0] = 1; amp[1] = K;
+          when[0] = 0; when[1] = 0.5f * td;
+        } break;
+        case SHAPER_ZVD: {
+          const float K = expf(-zeta * float(M_PI) / df);
+          sh.count = 3;
+          amp[0] = 1; amp[1] = 2 * K; amp[2] = sq(K);
+          when[0] = 0; when[1] = 0.5f * td; when[2] = td;
+        } break;
+        case SHAPER_MZV: {
+          const float K = expf(-0.75f * zeta * float(M_PI) / df);
+          sh.count = 3;
+          amp[0] = 1 - float(M_SQRT1_2); amp[1] = (float(M_SQRT2) - 1) * K; amp[2] = amp[0] * sq(K);
+          when[0] = 0; when[1] = 0.375f * td; when[2] = 0.75f * td;
+        } break;
+      }
+
+      // Amplitudes summing to exactly one step, so no fraction is left behind
+      float total = 0;
+      LOOP_L_N(i, sh.count) total += amp[i];
+      int32_t rest = 65536;
+      LOOP_L_N(i, sh.count) {
+        sh.amplitude[i] = i < sh.count - 1 ? LROUND(65536 * amp[i] / total) : rest;
+        rest -= sh.amplitude[i];
+        sh.delay[i] = LROUND(when[i] * (STEPPER_TIMER_RATE));
+      }
+    }
+
+    // Let the steps queued with the old impulses play out
+    planner.synchronize();
+
+    const bool was_enabled = STEPPER_ISR_ENABLED();
+    if (was_enabled) DISABLE_STEPPER_DRIVER_INTERRUPT();
+    shaper[axis] = sh;
+    shaping_queue_t &q = shaping_queue[axis];
+    LOOP_L_N(i, COUNT(q.tail)) q.tail[i] = q.head;
+    if (was_enabled) ENABLE_STEPPER_DRIVER_INTERRUPT();
+  }
+
+#endif // INPUT_SHAPING
+
 #if ENABLED(BABYSTEPPING)
 
   #if MINIMUM_STEPPER_PULSE
@@ -62,7 +62,7 @@
   #define ISR_BASE_CYCLES  792UL
 
   // Linear advance base time is 64 cycles
-  #if ENABLED(LIN_ADVANCE)
+  #if HAS_ADVANCE_ISR
     #define ISR_LA_BASE_CYCLES 64UL
   #else
     #define ISR_LA_BASE_CYCLES 0UL
@@ -90,7 +90,7 @@
   #define ISR_BASE_CYCLES  752UL
 
   // Linear advance base time is 32 cycles
-  #if ENABLED(LIN_ADVANCE)
+  #if HAS_ADVANCE_ISR
     #define ISR_LA_BASE_CYCLES 32UL
   #else
     #define ISR_LA_BASE_CYCLES 0UL
@@ -183,7 +183,7 @@
 #define ISR_LOOP_CYCLES (ISR_LOOP_BASE_CYCLES + _MAX(MIN_STEPPER_PULSE_CYCLES, MIN_ISR_LOOP_CYCLES))
 
 // If linear advance is enabled, then it is handled separately
-#if ENABLED(LIN_ADVANCE)
+#if HAS_ADVANCE_ISR
 
   // Estimate the minimum LA loop time
   #if ENABLED(MIXING_EXTRUDER) // ToDo: ???
@@ -220,6 +220,19 @@
 // The minimum allowable frequency for step smoothing will be 1/10 of the maximum nominal frequency (in Hz)
 #define MIN_STEP_ISR_FREQUENCY MAX_STEP_ISR_FREQUENCY_1X
 
+#if ENABLED(INPUT_SHAPING)
+  enum ShaperType : uint8_t { SHAPER_ZV, SHAPER_ZVD, SHAPER_MZV };
+
+  // Input shaper of one axis, as set with M593
+  typedef struct {
+    float frequency,        // (Hz) Resonance to cancel, 0 for no shaping
+          damping;          // Damping ratio of that resonance
+    ShaperType type;
+  } shaper_settings_t;
+
+  #define SHAPING_MOD(n) ((n)&(SHAPING_BUFFER_SIZE-1))
+#endif
+
 //
 // Stepper class definition
 //
@@ -239,6 +252,16 @@ class Stepper {
       static bool initialized;
     #endif
 
+    #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+      static uint32_t isr_cycles[8],          // Measured ISR execution time for 1x ... 128x stepping (peak, slowly decaying)
+                      isr_rate_limit[8];      // ISR rate above which the next multi-stepping factor is used
+      static uint8_t isr_load;                // Share of the CPU (%) the stepper ISR may take
+    #endif
+
+    #if ENABLED(INPUT_SHAPING)
+      static shaper_settings_t shaper_settings[2]; // X and Y
+    #endif
+
   private:
 
     static block_t* current_block;          // A pointer to the block currently being traced
@@ -306,17 +329,78 @@ class Stepper {
 
     static uint32_t nextMainISR;   // time remaining for the next Step ISR
     #if ENABLED(LIN_ADVANCE)
-      static uint32_t nextAdvanceISR, LA_isr_rate;
+      #if ENABLED(SMOOTH_LIN_ADVANCE)
+        static uint32_t LA_phase_end;                       // Step event where the current advance phase ends
+        static int32_t LA_adv_error, LA_adv_dividend, LA_adv_divisor; // Bresenham spreading the phase's advance steps
+        static int8_t LA_adv_dir,                           // Direction of the advance steps in this phase (0 = none)
+                      LA_e_dir;                             // Direction the E pin is set to (0 = unknown)
+        static uint8_t LA_phase;                            // 0 = acceleration, 1 = cruise, 2 = deceleration
+      #else
+        static uint32_t nextAdvanceISR, LA_isr_rate;
+      #endif
       static uint16_t LA_current_adv_steps, LA_final_adv_steps, LA_max_adv_steps; // Copy from current executed block. Needed because current_block is set to NULL "too early".
       static int8_t LA_steps;
       static bool LA_use_advance_lead;
     #endif // LIN_ADVANCE
 
+    #if ENABLED(INPUT_SHAPING)
+      // The impulses each X / Y step is split into
+      typedef struct {
+        uint8_t count;              // Impulses in use (1 without shaping)
+        uint32_t delay[3];          // Delay of each impulse (stepper timer ticks)
+        int32_t amplitude[3];       // Share of the step (65536 = whole step)
+      } shaper_t;
+
+      // Commanded X / Y steps waiting for their delayed impulses
+      typedef struct {
+        uint32_t step_time[SHAPING_BUFFER_SIZE]; // When each step was commanded, LSB set if reverse
+        uint16_t head,
+                 tail[3];           // The next step each impulse will apply
+        int32_t residual,           // Impulses applied but not output yet (65536 = whole step)
+                lag;                // Steps commanded (count_position) but not output yet
+        bool reverse;               // State of the direction pin
+      } shaping_queue_t;
+
+      static shaper_t shaper[2];
+      static shaping_queue_t shaping_queue[2];
+      static uint32_t nextShapingISR,   // Time remaining for the next impulse
+                      shaping_time;     // Stepper timer ticks since start, for the impulses
+    #endif
+
     static int32_t ticks_nominal;
     #if DISABLED(S_CURVE_ACCELERATION)
       static uint32_t acc_step_rate; // needed for deceleration start point
     #endif
 
+    #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+      typedef struct {
+        hal_timer_t interval;
+        uint8_t loops;
+      } step_timing_t;
+
+      // Ramp intervals for one block, worked out by prepare_step_schedule()
+      typedef struct {
+        block_t *block;               // The block these intervals were made for...
+        uint32_t initial_rate,        // ...and the trapezoid it had at the time
+                 nominal_rate,
+                 final_rate,
+                 acceleration_rate,
+                 accelerate_until,
+                 decelerate_after,
+                 step_event_count;
+        uint32_t peak_rate;           // acc_step_rate at the end of the acceleration
+        step_timing_t start,          // Interval for the block's initial_rate
+                      accel[STEP_SCHEDULE_SIZE],
+                      decel[STEP_SCHEDULE_SIZE];
+        uint8_t accel_count, decel_count;
+        volatile bool ready;          // Complete and not being rewritten
+      } step_schedule_t;
+
+      static step_schedule_t step_schedule[2];
+      static step_schedule_t *active_schedule;  // Claimed by the block phase for current_block
+      static uint8_t schedule_accel_index, schedule_decel_index;
+    #endif
+
     //
     // Exact steps at which an endstop was triggered
     //
@@ -353,9 +437,12 @@ class Stepper {
     // The stepper block processing phase ISR
     static uint32_t stepper_block_phase_isr();
 
-    #if ENABLED(LIN_ADVANCE)
+    #if HAS_ADVANCE_ISR
       // The Linear advance stepper ISR
       static uint32_t advance_isr();
+    #elif ENABLED(SMOOTH_LIN_ADVANCE)
+      // Spread the advance change of the next trapezoid phase over its step events
+      static void smooth_advance_phase();
     #endif
 
     // Check if the given block is busy or not - Must not be called from ISR contexts
@@ -464,6 +551,26 @@ class Stepper {
     // Set direction bits for all steppers
     static void set_directions();
 
+    #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+      // Recompute isr_rate_limit from the measured ISR times. Called from idle().
+      static void update_isr_limits();
+      // Forget the measurements and go back to the estimated limits
+      static void reset_isr_limits();
+      static void report_isr_limits();
+    #endif
+
+    #if ENABLED(INPUT_SHAPING)
+      // Work out the impulses for shaper_settings[axis], once the shaped moves are done
+      static void update_shaper(const AxisEnum axis);
+      // Delayed X / Y steps still to be output?
+      static bool shaping_busy();
+    #endif
+
+    #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+      // Fill in the step schedule for the block after the current one. Called from idle().
+      static void prepare_step_schedule();
+    #endif
+
   private:
 
     // Set the current position in steps
@@ -479,25 +586,33 @@ class Stepper {
       uint8_t multistep = 1;
       #if DISABLED(DISABLE_MULTI_STEPPING)
 
-        // The stepping frequency limits for each multistepping rate
-        static const uint32_t limit[] PROGMEM = {
-          (  MAX_STEP_ISR_FREQUENCY_1X     ),
-          (  MAX_STEP_ISR_FREQUENCY_2X >> 1),
-          (  MAX_STEP_ISR_FREQUENCY_4X >> 2),
-          (  MAX_STEP_ISR_FREQUENCY_8X >> 3),
-          ( MAX_STEP_ISR_FREQUENCY_16X >> 4),
-          ( MAX_STEP_ISR_FREQUENCY_32X >> 5),
-          ( MAX_STEP_ISR_FREQUENCY_64X >> 6),
-          (MAX_STEP_ISR_FREQUENCY_128X >> 7)
-        };
+        #if ENABLED(ADAPTIVE_MULTI_STEPPING)
+          // The stepping frequency limits, as measured on this board
+          const uint32_t * const limit = isr_rate_limit;
+          #define _LIMIT(I) limit[I]
+        #else
+          // The stepping frequency limits for each multistepping rate
+          static const uint32_t limit[] PROGMEM = {
+            (  MAX_STEP_ISR_FREQUENCY_1X     ),
+            (  MAX_STEP_ISR_FREQUENCY_2X >> 1),
+            (  MAX_STEP_ISR_FREQUENCY_4X >> 2),
+            (  MAX_STEP_ISR_FREQUENCY_8X >> 3),
+            ( MAX_STEP_ISR_FREQUENCY_16X >> 4),
+            ( MAX_STEP_ISR_FREQUENCY_32X >> 5),
+            ( MAX_STEP_ISR_FREQUENCY_64X >> 6),
+            (MAX_STEP_ISR_FREQUENCY_128X >> 7)
+          };
+          #define _LIMIT(I) (uint32_t)pgm_read_dword(&limit[I])
+        #endif
 
         // Select the proper multistepping
         uint8_t idx = 0;
-        while (idx < 7 && step_rate > (uint32_t)pgm_read_dword(&limit[idx])) {
+        while (idx < 7 && step_rate > _LIMIT(idx)) {
           step_rate >>= 1;
           multistep <<= 1;
           ++idx;
         };
+        #undef _LIMIT
       #else
         NOMORE(step_rate, uint32_t(MAX_STEP_ISR_FREQUENCY_1X));
       #endif
@@ -530,9 +645,26 @@ class Stepper {
       return timer;
     }
 
+    #if ENABLED(INPUT_SHAPING)
+      // The step ISR for the delayed X / Y impulses
+      static uint32_t shaping_isr();
+      // Room in the shaping queues for the steps of another pulse phase?
+      static bool shaping_has_room();
+      // Drop the delayed impulses, making the stepper position the output one
+      static void shaping_flush();
+    #endif
+
+    #if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+      static bool schedule_matches(const step_schedule_t &sched, const block_t * const block);
+      static void build_step_schedule(step_schedule_t &sched, block_t * const block);
+    #endif
+
     #if ENABLED(S_CURVE_ACCELERATION)
       static void _calc_bezier_curve_coeffs(const int32_t v0, const int32_t v1, const uint32_t av);
       static int32_t _eval_bezier_curve(const uint32_t curr_step);
+      #ifndef __AVR__
+        static int32_t _eval_bezier_curve_horner(const uint32_t curr_step);
+      #endif
     #endif
 
     #if HAS_DIGIPOTSS || HAS_MOTOR_CURRENT_PWM
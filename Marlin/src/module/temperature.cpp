@@ -99,7 +99,17 @@
   #include "../libs/buzzer.h"
 #endif
 
-#if HOTEND_USES_THERMISTOR
+#if ENABLED(BENCHMARK_COMMAND_PROFILE)
+  #include "../feature/benchmark.h"
+#endif
+
+#if HOTEND_USES_THERMISTOR && ENABLED(THERMISTOR_DIRECT_TABLES)
+  #if ENABLED(TEMP_SENSOR_1_AS_REDUNDANT)
+    static const int16_t* const heater_direct_map[2] = { HEATER_0_DIRECT_TABLE, HEATER_1_DIRECT_TABLE };
+  #else
+    static const int16_t* const heater_direct_map[HOTENDS] = ARRAY_BY_HOTENDS(HEATER_0_DIRECT_TABLE, HEATER_1_DIRECT_TABLE, HEATER_2_DIRECT_TABLE, HEATER_3_DIRECT_TABLE, HEATER_4_DIRECT_TABLE, HEATER_5_DIRECT_TABLE);
+  #endif
+#elif HOTEND_USES_THERMISTOR
   #if ENABLED(TEMP_SENSOR_1_AS_REDUNDANT)
     static void* heater_ttbl_map[2] = { (void*)HEATER_0_TEMPTABLE, (void*)HEATER_1_TEMPTABLE };
     static constexpr uint8_t heater_ttbllen_map[2] = { HEATER_0_TEMPTABLE_LEN, HEATER_1_TEMPTABLE_LEN };
@@ -1240,10 +1250,32 @@ void Temperature::manage_heater() {
   }                                                                    \
 }while(0)
 
+#if ENABLED(THERMISTOR_DIRECT_TABLES)
+  /**
+   * Index a direct table (see thermistors.h) by the top bits of 'raw'
+   * and interpolate with the rest. PGM selects a PROGMEM or SRAM table.
+   */
+  template<bool PGM>
+  static float direct_table_to_deg_c(const int16_t * const tbl, const int raw) {
+    const uint16_t r = constrain(raw, 0, MAX_RAW_THERMISTOR_VALUE),
+                   i = r >> (THERMISTOR_DIRECT_SHIFT),
+                   frac = r & (_BV(THERMISTOR_DIRECT_SHIFT) - 1);
+    const int16_t t0 = PGM ? int16_t(pgm_read_word(&tbl[i])) : tbl[i],
+                  t1 = PGM ? int16_t(pgm_read_word(&tbl[i + 1])) : tbl[i + 1];
+    return (t0 + ((int32_t(t1 - t0) * frac) >> (THERMISTOR_DIRECT_SHIFT))) * 0.0625f;
+  }
+  #define DIRECT_THERMISTOR_TABLE(TBL) return direct_table_to_deg_c<true>(TBL, raw)
+#endif
+
 #if HAS_USER_THERMISTORS
 
   user_thermistor_t Temperature::user_thermistor[USER_THERMISTORS]; // Initialized by settings.load()
 
+  #if ENABLED(THERMISTOR_DIRECT_TABLES)
+    // Expanded from the curve whenever its parameters change
+    static int16_t user_thermistor_direct[USER_THERMISTORS][THERMISTOR_DIRECT_SIZE];
+  #endif
+
   void Temperature::reset_user_thermistors() {
     user_thermistor_t user_thermistor[USER_THERMISTORS] = {
       #if ENABLED(HEATER_0_USER_THERMISTOR)
@@ -1337,8 +1369,23 @@ void Temperature::manage_heater() {
       t.beta_recip   = 1.0f / t.beta;
       t.sh_alpha     = RECIPROCAL(THERMISTOR_RESISTANCE_NOMINAL_C - (THERMISTOR_ABS_ZERO_C))
                         - (t.beta_recip * t.res_25_log) - (t.sh_c_coeff * cu(t.res_25_log));
+      #if ENABLED(THERMISTOR_DIRECT_TABLES)
+        // Evaluate the curve once per entry so readings need no logf()
+        for (uint16_t i = 0; i < THERMISTOR_DIRECT_SIZE; i++) {
+          const float c = user_thermistor_curve(t, int32_t(i) << (THERMISTOR_DIRECT_SHIFT)) * 16;
+          user_thermistor_direct[t_index][i] = int16_t(c < 0 ? c - 0.5f : c + 0.5f);
+        }
+      #endif
     }
 
+    #if ENABLED(THERMISTOR_DIRECT_TABLES)
+      return direct_table_to_deg_c<false>(user_thermistor_direct[t_index], raw);
+    #else
+      return user_thermistor_curve(t, raw);
+    #endif
+  }
+
+  float Temperature::user_thermistor_curve(const user_thermistor_t &t, const int raw) {
     // maximum adc value .. take into account the over sampling
     const int adc_max = MAX_RAW_THERMISTOR_VALUE,
               adc_raw = constrain(raw, 1, adc_max - 1); // constrain to prevent divide-by-zero
@@ -1457,7 +1504,10 @@ void Temperature::manage_heater() {
       default: break;
     }
 
-    #if HOTEND_USES_THERMISTOR
+    #if HOTEND_USES_THERMISTOR && ENABLED(THERMISTOR_DIRECT_TABLES)
+      // Thermistor with conversion table?
+      DIRECT_THERMISTOR_TABLE(heater_direct_map[e]);
+    #elif HOTEND_USES_THERMISTOR
       // Thermistor with conversion table?
       const short(*tt)[][2] = (short(*)[][2])(heater_ttbl_map[e]);
       SCAN_THERMISTOR_TABLE((*tt), heater_ttbllen_map[e]);
@@ -1473,6 +1523,8 @@ void Temperature::manage_heater() {
   float Temperature::analog_to_celsius_bed(const int raw) {
     #if ENABLED(HEATER_BED_USER_THERMISTOR)
       return user_thermistor_to_deg_c(CTI_BED, raw);
+    #elif ENABLED(HEATER_BED_USES_THERMISTOR) && ENABLED(THERMISTOR_DIRECT_TABLES)
+      DIRECT_THERMISTOR_TABLE(BED_DIRECT_TABLE);
     #elif ENABLED(HEATER_BED_USES_THERMISTOR)
       SCAN_THERMISTOR_TABLE(BED_TEMPTABLE, BED_TEMPTABLE_LEN);
     #elif ENABLED(HEATER_BED_USES_AD595)
@@ -1491,6 +1543,8 @@ void Temperature::manage_heater() {
   float Temperature::analog_to_celsius_chamber(const int raw) {
     #if ENABLED(HEATER_CHAMBER_USER_THERMISTOR)
       return user_thermistor_to_deg_c(CTI_CHAMBER, raw);
+    #elif ENABLED(HEATER_CHAMBER_USES_THERMISTOR) && ENABLED(THERMISTOR_DIRECT_TABLES)
+      DIRECT_THERMISTOR_TABLE(CHAMBER_DIRECT_TABLE);
     #elif ENABLED(HEATER_CHAMBER_USES_THERMISTOR)
       SCAN_THERMISTOR_TABLE(CHAMBER_TEMPTABLE, CHAMBER_TEMPTABLE_LEN);
     #elif ENABLED(HEATER_CHAMBER_USES_AD595)
@@ -2336,8 +2390,16 @@ void Temperature::readings_ready() {
 HAL_TEMP_TIMER_ISR() {
   HAL_timer_isr_prologue(TEMP_TIMER_NUM);
 
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.interrupt_start();
+  #endif
+
   Temperature::tick();
 
+  #if ENABLED(BENCHMARK_COMMAND_PROFILE)
+    benchmark.interrupt_end();
+  #endif
+
   HAL_timer_isr_epilogue(TEMP_TIMER_NUM);
 }
 
@@ -2600,6 +2662,21 @@ void Temperature::tick() {
     else obj.sample(HAL_READ_ADC()); \
   }while(0)
 
+  #if ENABLED(ADC_SCAN_SAMPLING)
+    /**
+     * The HAL converts every channel on its own, so a sensor can be read
+     * as soon as it's selected. Run through all the sensor states in one
+     * pass every ADC_SCAN_INTERVAL calls, instead of one state per call.
+     */
+    static_assert(HAL_ADC_READY(), "ADC_SCAN_SAMPLING requires HAL_ADC_READY() to be always true.");
+    static uint8_t scan_delay = ADC_SCAN_INTERVAL;
+    if (scan_delay) scan_delay--;
+    else {
+      scan_delay = (ADC_SCAN_INTERVAL) - 1;
+      adc_sensor_state = StartSampling;
+      while (adc_sensor_state != SensorsReady) {
+  #endif
+
   ADCSensorState next_sensor_state = adc_sensor_state < SensorsReady ? (ADCSensorState)(int(adc_sensor_state) + 1) : StartSampling;
 
   switch (adc_sensor_state) {
@@ -2723,6 +2800,11 @@ void Temperature::tick() {
   // Go to the next state
   adc_sensor_state = next_sensor_state;
 
+  #if ENABLED(ADC_SCAN_SAMPLING)
+      }
+    }
+  #endif
+
   //
   // Additional ~1KHz Tasks
   //
@@ -153,7 +153,11 @@ enum ADCSensorState : char {
 // get all oversampled sensor readings
 #define MIN_ADC_ISR_LOOPS 10
 
-#define ACTUAL_ADC_SAMPLES _MAX(int(MIN_ADC_ISR_LOOPS), int(SensorsReady))
+#if ENABLED(ADC_SCAN_SAMPLING)
+  #define ACTUAL_ADC_SAMPLES int(ADC_SCAN_INTERVAL)   // All sensors are read in one ISR pass
+#else
+  #define ACTUAL_ADC_SAMPLES _MAX(int(MIN_ADC_ISR_LOOPS), int(SensorsReady))
+#endif
 
 #if HAS_PID_HEATING
   #define PID_K2 (1-float(PID_K1))
@@ -434,10 +438,12 @@ class Temperature {
       static void log_user_thermistor(const uint8_t t_index, const bool eprom=false);
       static void reset_user_thermistors();
       static float user_thermistor_to_deg_c(const uint8_t t_index, const int raw);
+      static float user_thermistor_curve(const user_thermistor_t &t, const int raw);
       static bool set_pull_up_res(int8_t t_index, float value) {
         //if (!WITHIN(t_index, 0, USER_THERMISTORS - 1)) return false;
         if (!WITHIN(value, 1, 1000000)) return false;
         user_thermistor[t_index].series_res = value;
+        user_thermistor[t_index].pre_calc = true;
         return true;
       }
       static bool set_res25(int8_t t_index, float value) {
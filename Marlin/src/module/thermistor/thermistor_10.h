@@ -22,7 +22,7 @@
 #pragma once
 
 // R25 = 100 kOhm, beta25 = 3960 K, 4.7 kOhm pull-up, RS thermistor 198-961
-const short temptable_10[][2] PROGMEM = {
+constexpr short temptable_10[][2] PROGMEM = {
   { OV(   1), 929 },
   { OV(  36), 299 },
   { OV(  71), 246 },
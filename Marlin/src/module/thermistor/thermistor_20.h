@@ -24,7 +24,7 @@
 #define REVERSE_TEMP_SENSOR_RANGE
 
 // Pt100 with INA826 amp on Ultimaker v2.0 electronics
-const short temptable_20[][2] PROGMEM = {
+constexpr short temptable_20[][2] PROGMEM = {
   { OV(  0),    0 },
   { OV(227),    1 },
   { OV(236),   10 },
@@ -24,7 +24,7 @@
 #define REVERSE_TEMP_SENSOR_RANGE
 
 // Pt100 with LMV324 amp on Overlord v1.1 electronics
-const short temptable_201[][2] PROGMEM = {
+constexpr short temptable_201[][2] PROGMEM = {
   { OV(   0),   0 },
   { OV(   8),   1 },
   { OV(  23),   6 },
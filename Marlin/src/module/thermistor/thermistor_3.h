@@ -22,7 +22,7 @@
 #pragma once
 
 // R25 = 100 kOhm, beta25 = 4120 K, 4.7 kOhm pull-up, mendel-parts
-const short temptable_3[][2] PROGMEM = {
+constexpr short temptable_3[][2] PROGMEM = {
   { OV(   1), 864 },
   { OV(  21), 300 },
   { OV(  25), 290 },
@@ -26,7 +26,7 @@
 // ATC Semitec 104GT-2/104NT-4-R025H42G (Used in ParCan)
 // Verified by linagee. Source: http://shop.arcol.hu/static/datasheets/thermistors.pdf
 // Calculated using 4.7kohm pullup, voltage divider math, and manufacturer provided temp/resistance
-const short temptable_5[][2] PROGMEM = {
+constexpr short temptable_5[][2] PROGMEM = {
   { OV(   1), 713 },
   { OV(  17), 300 }, // top rating 300C
   { OV(  20), 290 },
@@ -22,7 +22,7 @@
 
 // 100k thermistor supplied with RPW-Ultra hotend, 4.7k pullup
 
-const short temptable_512[][2] PROGMEM = {
+constexpr short temptable_512[][2] PROGMEM = {
   { OV(26),  300 },
   { OV(28),  295 },
   { OV(30),  290 },
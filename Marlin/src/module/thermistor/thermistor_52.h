@@ -26,7 +26,7 @@
 // Verified by linagee. Source: http://shop.arcol.hu/static/datasheets/thermistors.pdf
 // Calculated using 1kohm pullup, voltage divider math, and manufacturer provided temp/resistance
 // Advantage: More resolution and better linearity from 150C to 200C
-const short temptable_52[][2] PROGMEM = {
+constexpr short temptable_52[][2] PROGMEM = {
   { OV(   1), 500 },
   { OV( 125), 300 }, // top rating 300C
   { OV( 142), 290 },
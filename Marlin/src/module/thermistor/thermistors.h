@@ -166,7 +166,7 @@
   #include "thermistor_999.h"
 #endif
 #if ANY_THERMISTOR_IS(1000) // Custom
-  const short temptable_1000[][2] PROGMEM = { { 0, 0 } };
+  constexpr short temptable_1000[][2] PROGMEM = { { 0, 0 } };
 #endif
 
 #define _TT_NAME(_N) temptable_ ## _N
@@ -259,6 +259,92 @@ static_assert(
   "Temperature conversion tables over 255 entries need special consideration."
 );
 
+#if ENABLED(THERMISTOR_DIRECT_TABLES)
+
+  /**
+   * Direct-indexed tables, expanded from the tables above at compile time.
+   * Entry i holds °C * 16 at raw value (i << THERMISTOR_DIRECT_SHIFT), so a
+   * reading takes one shift and one fixed-point interpolation.
+   */
+  constexpr uint8_t thermistor_log2(const uint32_t n) { return n > 1 ? 1 + thermistor_log2(n >> 1) : 0; }
+  #define THERMISTOR_DIRECT_SHIFT (thermistor_log2(MAX_RAW_THERMISTOR_VALUE + 1) - (THERMISTOR_DIRECT_BITS))
+  #define THERMISTOR_DIRECT_SIZE (_BV(THERMISTOR_DIRECT_BITS) + 1)
+
+  typedef struct { int16_t temp[THERMISTOR_DIRECT_SIZE]; } thermistor_direct_t;
+
+  // °C * 16 at 'raw', interpolated and clamped the same way as SCAN_THERMISTOR_TABLE
+  constexpr int16_t thermistor_direct_round(const float t) { return int16_t(t < 0 ? t - 0.5f : t + 0.5f); }
+  constexpr int16_t thermistor_direct_temp(const short (*tbl)[2], const uint8_t len, const int32_t raw, const uint8_t i=1) {
+    return raw <= tbl[0][0] ? tbl[0][1] * 16
+         : i >= len ? tbl[len - 1][1] * 16
+         : raw > tbl[i][0] ? thermistor_direct_temp(tbl, len, raw, i + 1)
+         : thermistor_direct_round(16 * (tbl[i - 1][1] + (raw - tbl[i - 1][0]) * float(tbl[i][1] - tbl[i - 1][1]) / float(tbl[i][0] - tbl[i - 1][0])));
+  }
+
+  // 0 .. N-1 as a parameter pack, built by halves to keep the template depth down
+  template<int... I> struct thermistor_index_seq { typedef thermistor_index_seq type; };
+  template<typename A, typename B> struct thermistor_seq_join;
+  template<int... A, int... B> struct thermistor_seq_join<thermistor_index_seq<A...>, thermistor_index_seq<B...>>
+    : thermistor_index_seq<A..., int(sizeof...(A)) + B...> {};
+  template<int N> struct thermistor_make_seq
+    : thermistor_seq_join<typename thermistor_make_seq<N / 2>::type, typename thermistor_make_seq<N - N / 2>::type> {};
+  template<> struct thermistor_make_seq<0> : thermistor_index_seq<> {};
+  template<> struct thermistor_make_seq<1> : thermistor_index_seq<0> {};
+
+  template<int... I>
+  constexpr thermistor_direct_t thermistor_direct_expand(const short (*tbl)[2], const uint8_t len, thermistor_index_seq<I...>) {
+    return { { thermistor_direct_temp(tbl, len, int32_t(I) << THERMISTOR_DIRECT_SHIFT)... } };
+  }
+
+  #define DIRECT_TEMPTABLE(TBL) thermistor_direct_expand(TBL, COUNT(TBL), thermistor_make_seq<THERMISTOR_DIRECT_SIZE>::type())
+
+  #if THERMISTOR_HEATER_0 && DISABLED(HEATER_0_USER_THERMISTOR)
+    constexpr thermistor_direct_t heater_0_direct PROGMEM = DIRECT_TEMPTABLE(HEATER_0_TEMPTABLE);
+    #define HEATER_0_DIRECT_TABLE heater_0_direct.temp
+  #else
+    #define HEATER_0_DIRECT_TABLE nullptr
+  #endif
+  #if THERMISTOR_HEATER_1 && DISABLED(HEATER_1_USER_THERMISTOR)
+    constexpr thermistor_direct_t heater_1_direct PROGMEM = DIRECT_TEMPTABLE(HEATER_1_TEMPTABLE);
+    #define HEATER_1_DIRECT_TABLE heater_1_direct.temp
+  #else
+    #define HEATER_1_DIRECT_TABLE nullptr
+  #endif
+  #if THERMISTOR_HEATER_2 && DISABLED(HEATER_2_USER_THERMISTOR)
+    constexpr thermistor_direct_t heater_2_direct PROGMEM = DIRECT_TEMPTABLE(HEATER_2_TEMPTABLE);
+    #define HEATER_2_DIRECT_TABLE heater_2_direct.temp
+  #else
+    #define HEATER_2_DIRECT_TABLE nullptr
+  #endif
+  #if THERMISTOR_HEATER_3 && DISABLED(HEATER_3_USER_THERMISTOR)
+    constexpr thermistor_direct_t heater_3_direct PROGMEM = DIRECT_TEMPTABLE(HEATER_3_TEMPTABLE);
+    #define HEATER_3_DIRECT_TABLE heater_3_direct.temp
+  #else
+    #define HEATER_3_DIRECT_TABLE nullptr
+  #endif
+  #if THERMISTOR_HEATER_4 && DISABLED(HEATER_4_USER_THERMISTOR)
+    constexpr thermistor_direct_t heater_4_direct PROGMEM = DIRECT_TEMPTABLE(HEATER_4_TEMPTABLE);
+    #define HEATER_4_DIRECT_TABLE heater_4_direct.temp
+  #else
+    #define HEATER_4_DIRECT_TABLE nullptr
+  #endif
+  #if THERMISTOR_HEATER_5 && DISABLED(HEATER_5_USER_THERMISTOR)
+    constexpr thermistor_direct_t heater_5_direct PROGMEM = DIRECT_TEMPTABLE(HEATER_5_TEMPTABLE);
+    #define HEATER_5_DIRECT_TABLE heater_5_direct.temp
+  #else
+    #define HEATER_5_DIRECT_TABLE nullptr
+  #endif
+  #if defined(THERMISTORBED) && DISABLED(HEATER_BED_USER_THERMISTOR)
+    constexpr thermistor_direct_t bed_direct PROGMEM = DIRECT_TEMPTABLE(BED_TEMPTABLE);
+    #define BED_DIRECT_TABLE bed_direct.temp
+  #endif
+  #if defined(THERMISTORCHAMBER) && DISABLED(HEATER_CHAMBER_USER_THERMISTOR)
+    constexpr thermistor_direct_t chamber_direct PROGMEM = DIRECT_TEMPTABLE(CHAMBER_TEMPTABLE);
+    #define CHAMBER_DIRECT_TABLE chamber_direct.temp
+  #endif
+
+#endif // THERMISTOR_DIRECT_TABLES
+
 // Set the high and low raw values for the heaters
 // For thermistors the highest temperature results in the lowest ADC value
 // For thermocouples the highest temperature results in the highest ADC value
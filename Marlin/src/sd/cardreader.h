@@ -40,11 +40,7 @@ typedef struct {
        mounted:1,
        filenameIsDir:1,
        workDirIsRoot:1,
-       abort_sd_printing:1
-       #if ENABLED(BINARY_FILE_TRANSFER)
-         , binary_mode:1
-       #endif
-    ;
+       abort_sd_printing:1;
 } card_flags_t;
 
 class CardReader {
@@ -53,15 +49,6 @@ public:
   static char filename[FILENAME_LENGTH],            // DOS 8.3 filename of the selected item
               longFilename[LONG_FILENAME_LENGTH];   // Long name of the selected item
 
-  // Fast! binary file transfer
-  #if ENABLED(BINARY_FILE_TRANSFER)
-    #if NUM_SERIAL > 1
-      static int8_t transfer_port_index;
-    #else
-      static constexpr int8_t transfer_port_index = 0;
-    #endif
-  #endif
-
   // // // Methods // // //
 
   CardReader();
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+
+""" Encode G-code as binary stream packets for BINARY_GCODE_STREAMING.
+
+The output is the byte stream a host sends after "M28 B1": G-code packets of
+up to --size bytes, each one acknowledged by the firmware with "ok<sync>",
+then a CLOSE packet to switch back to ASCII. The Linux native MOTION_BENCHMARK
+build replays such a file directly.
+
+Command encoding (see BinaryGcodeProtocol in Marlin/src/feature/binary_protocol.h):
+  Text  0xC0, the line, '\\0'
+  Code  head (bits 7-6 G/M/T, bit 5 subcode, bits 4-0 parameter count),
+        code number (varint), [subcode byte], parameters:
+        head (bits 7-5 0 = no value, 1 = integer, 2-7 = 1-6 decimal places,
+        bits 4-0 letter - 'A') and zigzag varint value
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+__license__ = "GPL"
+
+HEADER_TOKEN = 0xB5AD
+PROTOCOL_CONTROL, PROTOCOL_GCODE = 0, 2
+CONTROL_CLOSE = 2
+GCODE_COMMANDS = 1
+
+# M-codes that take the rest of the line as a string
+STRING_CODES = { 16, 20, 23, 28, 30, 32, 33, 117, 118, 810, 811, 812, 813, 814, 815, 816, 817, 818, 819, 928 }
+
+CODE_RE = re.compile(r'([GMT])(\d+)(?:\.(\d+))?$')
+PARAM_RE = re.compile(r'([A-Z])([-+]?(?:\d+\.?\d*|\.\d+))?$')
+
+def fletcher16(cs, data):
+  for b in bytearray(data):
+    low = ((cs & 0xFF) + b) % 255
+    cs = ((((cs >> 8) + low) % 255) << 8) | low
+  return cs
+
+def varint(v):
+  out = bytearray()
+  while True:
+    b = v & 0x7F
+    v >>= 7
+    if v:
+      out.append(b | 0x80)
+    else:
+      out.append(b)
+      return out
+
+def zigzag(n):
+  return (n << 1) if n >= 0 else ((-n - 1) << 1) | 1
+
+def strip_line(line):
+  """ Drop comments, line number and checksum, as the firmware would. """
+  line = line.split(';', 1)[0]
+  line = re.sub(r'\([^)]*\)', '', line)
+  line = line.split('*', 1)[0].strip()
+  line = re.sub(r'^N\d+\s*', '', line)
+  return line
+
+def encode_value(value):
+  """ Return (kind, zigzag mantissa) for a parameter value, or None. """
+  if '.' not in value:
+    kind, mantissa = 1, int(value)
+  else:
+    whole, frac = value.split('.')
+    frac = frac.rstrip('0')
+    if len(frac) > 6: return None
+    sign = -1 if whole.startswith('-') else 1
+    whole = whole.lstrip('+-') or '0'
+    mantissa = sign * int(whole + frac)
+    kind = len(frac) + 1
+  if not -2**31 < mantissa < 2**31: return None
+  return kind, zigzag(mantissa)
+
+def encode_command(line):
+  """ Encode one G-code line. Lines it can't express go as text. """
+  text = bytearray(b'\xC0') + line.encode('ascii') + b'\0'
+  words = line.split()
+  code = CODE_RE.match(words[0]) if words else None
+  if not code: return text
+  letter, number, sub = code.group(1), int(code.group(2)), code.group(3)
+  if letter == 'M' and number in STRING_CODES: return text
+  if sub is not None and int(sub) > 255: return text
+
+  params = bytearray()
+  for word in words[1:]:
+    m = PARAM_RE.match(word)
+    if not m: return text
+    index = ord(m.group(1)) - ord('A')
+    if m.group(2) is None:
+      params.append(index)
+      continue
+    value = encode_value(m.group(2))
+    if not value: return text
+    params.append(value[0] << 5 | index)
+    params += varint(value[1])
+  count = len(words) - 1
+  if count > 31: return text
+
+  head = 'GMT'.index(letter) << 6 | (0x20 if sub is not None else 0) | count
+  out = bytearray([head]) + varint(number)
+  if sub is not None: out.append(int(sub))
+  out += params
+  return out if len(out) < len(text) else text
+
+def packet(sync, protocol, ptype, payload=b''):
+  header = struct.pack('<BBH', sync, protocol << 4 | ptype, len(payload))
+  header_cs = fletcher16(0, header)
+  out = struct.pack('<H', HEADER_TOKEN) + header + struct.pack('<H', header_cs)
+  if payload:
+    # The packet checksum runs on over the header checksum and the payload
+    cs = fletcher16(fletcher16(header_cs, struct.pack('<H', header_cs)), payload)
+    out += bytes(payload) + struct.pack('<H', cs)
+  return out
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('input', help='G-code file')
+  parser.add_argument('output', help='Binary stream file')
+  parser.add_argument('-s', '--size', type=int, default=96, help='Largest packet payload, MAX_CMD_SIZE (default=96)')
+  parser.add_argument('--sync', type=int, default=0, help='Sync number of the first packet (default=0)')
+  parser.add_argument('--no-close', action='store_true', help="Don't end with a CLOSE packet")
+  args = parser.parse_args()
+
+  sync = args.sync & 0xFF
+  out = bytearray()
+  payload = bytearray()
+  commands = ascii_bytes = 0
+
+  def flush():
+    nonlocal sync, out, payload
+    if payload:
+      out += packet(sync, PROTOCOL_GCODE, GCODE_COMMANDS, payload)
+      sync = (sync + 1) & 0xFF
+      payload = bytearray()
+
+  with open(args.input) as f:
+    for raw in f:
+      line = strip_line(raw)
+      if not line: continue
+      # The same line as sent by a host with line number and checksum
+      numbered = 'N%d %s' % (commands + 1, line)
+      xor = 0
+      for c in numbered: xor ^= ord(c)
+      ascii_bytes += len('%s*%d\n' % (numbered, xor))
+      commands += 1
+      cmd = encode_command(line)
+      if len(cmd) > args.size: sys.exit('Line too long: ' + line)
+      if len(payload) + len(cmd) > args.size: flush()
+      payload += cmd
+  flush()
+
+  if not args.no_close:
+    out += packet(sync, PROTOCOL_CONTROL, CONTROL_CLOSE)
+
+  with open(args.output, 'wb') as f:
+    f.write(out)
+
+  print('%d commands: %d bytes as numbered ASCII, %d bytes binary (%.2fx)' % (
+    commands, ascii_bytes, len(out), ascii_bytes / len(out) if out else 0), file=sys.stderr)
+
+if __name__ == '__main__':
+  main()
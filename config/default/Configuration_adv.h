@@ -298,6 +298,39 @@
 // This shouldn't need to be more than 30 seconds (30000)
 //#define MILLISECONDS_PREHEAT_TIME 0
 
+/**
+ * Scanned ADC sampling
+ *
+ * Where the ADC converts all channels by itself (LPC176x burst mode, SAMD51
+ * DMA, Linux simulator) any sensor can be read without waiting. Read them all
+ * in one pass of the temperature ISR every ADC_SCAN_INTERVAL ms, instead of
+ * starting one conversion and reading another on each pass. With fewer
+ * passes per round, the heaters are updated several times more often.
+ */
+//#define ADC_SCAN_SAMPLING
+#if ENABLED(ADC_SCAN_SAMPLING)
+  #define ADC_SCAN_INTERVAL 2   // (ms) Temperature ISR passes per scan (1-255)
+#endif
+
+/**
+ * Direct-indexed thermistor tables
+ *
+ * Expand each thermistor table at compile time into 2^THERMISTOR_DIRECT_BITS+1
+ * evenly spaced entries, so a raw reading indexes the table with a shift
+ * instead of a binary search. User thermistors (1000) get the same table in
+ * SRAM, rebuilt when M305 or settings change their parameters, so readings
+ * need no logf(). Costs 2 bytes of flash (SRAM for user thermistors) per entry.
+ *
+ * With 10 bits there's an entry for every count of the 10-bit tables and the
+ * result matches the table search to 0.1°C. Fewer bits save space, but NTC
+ * curves are steep at the hot end: at 8 bits some tables read several degrees
+ * off near their hottest entries.
+ */
+//#define THERMISTOR_DIRECT_TABLES
+#if ENABLED(THERMISTOR_DIRECT_TABLES)
+  #define THERMISTOR_DIRECT_BITS 10  // 1025 entries per sensor (4-10)
+#endif
+
 // @section extruder
 
 // Extruder runout prevention.
@@ -823,6 +856,61 @@
  */
 //#define ADAPTIVE_STEP_SMOOTHING
 
+/**
+ * Fixed-point trapezoid calculation for boards without an FPU (AVR, Cortex-M0/M3).
+ * Computes the block step rates and acceleration / deceleration points with
+ * integer math instead of software-emulated float. With MOTION_BENCHMARK every
+ * result is also checked against the float version (and timed with it).
+ */
+//#define PLANNER_FIXED_POINT
+
+/**
+ * Adaptive Multi-Stepping
+ * Measure the stepper ISR execution time on the running board and derive the step
+ * rates at which 2x, 4x ... 128x stepping kicks in from it, instead of using the
+ * worst-case cycle estimates. Fast boards keep single-stepping at higher rates.
+ * M318 reports the measured ISR times and the resulting limits. 32-bit boards only.
+ */
+//#define ADAPTIVE_MULTI_STEPPING
+#if ENABLED(ADAPTIVE_MULTI_STEPPING)
+  #define MULTI_STEPPING_ISR_LOAD 70  // (%) Share of CPU time the stepper ISR may take
+#endif
+
+/**
+ * Precomputed Step Schedule
+ * Work out the timer intervals for the acceleration and deceleration ramps of
+ * the next block in the background (from idle) so the stepper ISR only has to
+ * look them up. Ramps longer than the table continue with the live calculation.
+ * Trapezoidal acceleration only.
+ */
+//#define PRECOMPUTED_STEP_SCHEDULE
+#if ENABLED(PRECOMPUTED_STEP_SCHEDULE)
+  #define STEP_SCHEDULE_SIZE 32   // Intervals stored for each ramp (8 bytes each on 32-bit)
+#endif
+
+/**
+ * Input Shaping
+ * Cancel the ringing of the X and Y axes at their resonant frequency by splitting
+ * each step into two or three delayed impulses. The frequency can be read from the
+ * spacing of the ripples on a test print (speed / spacing). Set with M593.
+ *  ZV  : Two impulses, shortest delay (half a period). Needs an accurate frequency.
+ *  ZVD : Three impulses over a full period. Tolerates more frequency error.
+ *  MZV : Three impulses over 3/4 of a period. In between.
+ * Cartesian machines only.
+ */
+//#define INPUT_SHAPING
+#if ENABLED(INPUT_SHAPING)
+  #define SHAPING_FREQ_X        40  // (Hz) Resonant frequency of the X axis. 0 = No shaping.
+  #define SHAPING_FREQ_Y        40  // (Hz) Resonant frequency of the Y axis. 0 = No shaping.
+  #define SHAPING_DAMPING_X   0.10  // Damping ratio of the X resonance (0.0 - 0.99)
+  #define SHAPING_DAMPING_Y   0.10  // Damping ratio of the Y resonance (0.0 - 0.99)
+  #define SHAPING_TYPE_X SHAPER_MZV // SHAPER_ZV, SHAPER_ZVD or SHAPER_MZV
+  #define SHAPING_TYPE_Y SHAPER_MZV
+  // Steps remembered per axis (4 bytes each). Must hold (max steps/s) x (longest impulse delay)
+  // or moves will be slowed down. A power of 2, 256 or more.
+  #define SHAPING_BUFFER_SIZE 1024
+#endif
+
 /**
  * Custom Microstepping
  * Override as-needed for your setup. Up to 3 MS pins are supported.
@@ -1417,6 +1505,19 @@
   //#define EXTRA_LIN_ADVANCE_K // Enable for second linear advance constants
   #define LIN_ADVANCE_K 0.22    // Unit: mm compression per 1mm/s extruder speed
   //#define LA_DEBUG            // If enabled, this will generate debug information output over USB.
+
+  /**
+   * Plan the advance of each acceleration, cruise and deceleration phase with
+   * the block and add it to the E steps in the main stepper ISR, up to four
+   * advance steps per step event. This drops the separate extruder ISR and its
+   * rate limits, so larger K values keep up at high speed. Pressure changes are
+   * spread over LIN_ADVANCE_SMOOTH_TIME, and released during travel moves.
+   * Not compatible with MIXING_EXTRUDER or I2S_STEPPER_STREAM.
+   */
+  //#define SMOOTH_LIN_ADVANCE
+  #if ENABLED(SMOOTH_LIN_ADVANCE)
+    #define LIN_ADVANCE_SMOOTH_TIME 0.04  // (s) 0 to step the advance at once. Override with M900 W.
+  #endif
 #endif
 
 // @section leveling
@@ -1516,6 +1617,25 @@
 // Moves (or segments) with fewer steps than this will be joined with the next move
 #define MIN_STEPS_PER_SEGMENT 6
 
+/**
+ * Segment Coalescing
+ *
+ * Merge runs of short, nearly collinear moves into a single planner block
+ * before they are queued. This saves planner time on finely tessellated
+ * models and lets the block buffer look further ahead.
+ *
+ * A merged move passes within COALESCE_TOLERANCE of every point it drops,
+ * and the E-per-mm ratio of each merged segment stays within
+ * COALESCE_E_TOLERANCE of the first one. Cartesian machines only.
+ */
+//#define SEGMENT_COALESCING
+#if ENABLED(SEGMENT_COALESCING)
+  #define COALESCE_TOLERANCE    0.005 // (mm) Max distance from a dropped point to the merged move
+  #define COALESCE_E_TOLERANCE  0.02  // Max relative change in E per mm between merged segments
+  #define COALESCE_MAX_LENGTH   2.0   // (mm) Don't merge beyond this length
+  #define COALESCE_MAX_SEGMENTS 8     // Max segments in one merged move
+#endif
+
 /**
  * Minimum delay before and after setting the stepper DIR (in ns)
  *     0 : No delay (Expect at least 10µS since one Stepper ISR must transpire)
@@ -1578,12 +1698,52 @@
   #define BLOCK_BUFFER_SIZE 16 // maximize block buffer
 #endif
 
+// 32-bit boards with RAM to spare may use a much larger block buffer (e.g. 512)
+// for more look-ahead when printing short segments at high speed. Buffers
+// over 256 blocks use 16-bit ring indices. Each block takes roughly 100 bytes.
+// Optionally place the buffer in a dedicated linker section, such as the
+// STM32F4 CCM RAM, to keep it out of the main heap / stack region.
+//#define BLOCK_BUFFER_SECTION ".ccmram"
+
 // @section serial
 
 // The ASCII buffer for serial input
 #define MAX_CMD_SIZE 96
 #define BUFSIZE 4
 
+/**
+ * Pre-parsed command queue
+ *
+ * Parse commands as they arrive and queue their code and parameter values
+ * instead of the text. Commands then run without being parsed again and
+ * each one takes 12 + 4 * PREPARSED_MAX_VALUES bytes instead of MAX_CMD_SIZE,
+ * so BUFSIZE can be raised in the same RAM.
+ *
+ * Commands with string arguments, flags without a value, or more values keep
+ * their text in one of PREPARSED_TEXT_LINES buffers. So do all commands while
+ * writing to SD (M28 / M928). Requires FASTER_GCODE_PARSER.
+ */
+//#define PREPARSED_COMMAND_QUEUE
+#if ENABLED(PREPARSED_COMMAND_QUEUE)
+  #define PREPARSED_MAX_VALUES 6  // Parameter values per command (1-8)
+  #define PREPARSED_TEXT_LINES 2  // Commands that can keep their text
+#endif
+
+/**
+ * Binary G-code Streaming
+ *
+ * After "M28 B1" accept G-code as packets of the binary stream protocol
+ * (see BINARY_FILE_TRANSFER) instead of text lines. Each command is encoded
+ * in a few bytes: the code, then every parameter as its letter and a varint
+ * (integer or decimal with 1-6 places). Commands it can't express are sent as
+ * text inside the packet. Packets are checksummed and acknowledged once all
+ * their commands are queued, which replaces "N...*checksum" and "ok" per line.
+ *
+ * buildroot/share/scripts/binary_gcode.py encodes G-code files for it.
+ * No SD card needed. Printing to SD still uses BINARY_FILE_TRANSFER.
+ */
+//#define BINARY_GCODE_STREAMING
+
 // Transmission to Host Buffer Size
 // To save 386 bytes of PROGMEM (and TX_BUFFER_SIZE+3 bytes of RAM) set to 0.
 // To buffer a simple "ok" you need 4 bytes.
@@ -1608,6 +1768,12 @@
 // Add M575 G-code to change the baud rate
 //#define BAUD_RATE_GCODE
 
+// LPC176x hardware UARTs: Receive into a circular DMA buffer of RX_BUFFER_SIZE
+// bytes instead of taking an interrupt for every character. Helps at 250000
+// baud and up, where the receive interrupt competes with the stepper ISR.
+// RX_BUFFER_SIZE must be a power of 2. Has no effect on USB serial.
+//#define SERIAL_DMA
+
 #if ENABLED(SDSUPPORT)
   // Enable this option to collect and display the maximum
   // RX queue usage after transferring a file to SD.
@@ -1633,6 +1799,51 @@
 // Some clients will have this feature soon. This could make the NO_TIMEOUTS unnecessary.
 //#define ADVANCED_OK
 
+/**
+ * Credit-based Flow Control
+ *
+ * Let the host stream without waiting for an "ok" per command. "M577 S1"
+ * (Cap:CREDIT_FLOW in M115) grants the host BUFSIZE commands of credit and
+ * from then on commands are acknowledged in batches with "ok C<n>", each one
+ * returning n credits. The host may send as long as it has credit left.
+ * Lines dropped for a resend have their credit returned with the "Resend".
+ * Other "ok" replies (like "ok T:" from M105) carry no credit.
+ */
+//#define SERIAL_CREDIT_FLOW
+#if ENABLED(SERIAL_CREDIT_FLOW)
+  #define CREDIT_FLOW_BATCH 2     // Credits to collect before returning them (1-BUFSIZE)
+#endif
+
+/**
+ * Selective Resend
+ *
+ * A bad or missing line no longer throws away everything received after it.
+ * Good lines that follow are held until the missing one arrives, and the host
+ * is asked to resend only the lines still missing (Cap:SELECTIVE_RESEND in
+ * M115). Copies of lines already received are acknowledged and ignored, so
+ * hosts that resend everything from the requested line still work.
+ */
+//#define SERIAL_SELECTIVE_RESEND
+#if ENABLED(SERIAL_SELECTIVE_RESEND)
+  #define RESEND_BUFFER_LINES 4   // Lines held while waiting for a resend
+#endif
+
+/**
+ * Serial Port Scheduler
+ *
+ * With two serial ports, share the command queue fairly instead of always
+ * reading the first port first. The port that sent the latest move owns the
+ * print. It may queue PRINT_PORT_WEIGHT lines for each line from the other
+ * port, and the other port (e.g., a touch display or a WiFi bridge) can't
+ * take more than OTHER_PORT_QUEUE commands of the queue from it.
+ * Use M578 to see how each port is served.
+ */
+//#define SERIAL_PORT_SCHEDULER
+#if ENABLED(SERIAL_PORT_SCHEDULER)
+  #define PRINT_PORT_WEIGHT 4     // Lines from the print port per line from the other port
+  #define OTHER_PORT_QUEUE  2     // Queued commands allowed from the other port (1-BUFSIZE)
+#endif
+
 // Printrun may have trouble receiving long strings all at once.
 // This option inserts short delays between lines of serial output.
 #define SERIAL_OVERRUN_PROTECTION
@@ -2550,6 +2761,14 @@
  */
 #define FASTER_GCODE_PARSER
 
+/**
+ * Read parameter values with a small scanner for G-code numbers
+ * instead of the larger and slower strtod / strtol. Floats with more
+ * than 7 significant digits may differ in the last bit or two.
+ * Exponents are not read.
+ */
+//#define GCODE_DECIMAL_SCANNER
+
 /**
  * CNC G-code options
  * Support CNC-style G-code dialects used by laser cutters, drawing machine cams, etc.
@@ -2865,3 +3084,28 @@
 
 // Enable Marlin dev mode which adds some special commands
 //#define MARLIN_DEV_MODE
+
+/**
+ * Motion Benchmark for the Linux native build
+ *
+ * Replays a G-code file (or stdin) through the parser, planner and stepper ISR
+ * and prints throughput figures measured with the simulated Clock at EOF:
+ * blocks planned per second, ISR cycles per step, worst-case block phase time
+ * and planner starvation events.
+ *
+ * Usage: marlin [gcode_file [time_multiplier]]
+ * A time_multiplier above 1 replays the file faster than real time.
+ */
+//#define MOTION_BENCHMARK
+#if ENABLED(MOTION_BENCHMARK)
+  // Resonance of the simulated X / Y carriage, to report the ringing with INPUT_SHAPING
+  #define BENCHMARK_RESONANCE_FREQ     40  // (Hz)
+  #define BENCHMARK_RESONANCE_DAMPING 0.1
+  // Deliver the G-code no faster than a serial line at this rate (0 = unlimited)
+  #define BENCHMARK_SERIAL_BAUD        0
+  // Time every G / M / T code and list them by CPU time spent, with the
+  // number of times the planner ran dry while each one was running.
+  // The host's cost of delivering timer signals still lands on the code they
+  // interrupt, so use a large time_multiplier to compare handlers.
+  //#define BENCHMARK_COMMAND_PROFILE
+#endif